@@ -0,0 +1,237 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "memory_literals.h"
+
+namespace sot::core {
+
+using namespace memory_literals;
+
+/**
+ * \brief Пул выровненных буферов фиксированной емкости, которые переиспользуются вместо выделения.
+ *
+ * Буферы выравниваются по странице, а при использовании больших страниц - по их размеру, и
+ * выделяются только тогда, когда свободных нет. Возвращенные буферы хранятся до вызова
+ * @link Trim @endlink или уничтожения пула, поэтому их страницы не освобождаются и повторно не
+ * вызывают отказов страниц.
+ *
+ * \tparam Value тип элементов буфера.
+ */
+template <typename Value>
+class BufferPool {
+ public:
+  /// Выравнивание буферов.
+  static constexpr size_t kAlignment = 4_KiB;
+  /// Размер большой страницы и выравнивание буферов, которые ее используют.
+  static constexpr size_t kHugePageSize = 2_MiB;
+
+  /**
+   * \brief Буфер, взятый из пула и возвращаемый в него при уничтожении.
+   */
+  class Buffer {
+   public:
+    Buffer() = default;
+    Buffer(Buffer &&other) noexcept;
+    Buffer &operator=(Buffer &&other) noexcept;
+    ~Buffer();
+
+    /**
+     * \brief Получить элементы буфера, их количество равно емкости пула.
+     */
+    [[nodiscard]] std::span<Value> Get() const;
+
+   private:
+    friend class BufferPool;
+
+    BufferPool *pool_ = nullptr;
+    Value *data_ = nullptr;
+
+    Buffer(BufferPool &pool, Value *data);
+    void Return();
+  };
+
+  /**
+   * \param capacity количество элементов в каждом буфере;
+   * \param huge_pages просить ядро размещать буферы на больших страницах.
+   */
+  explicit BufferPool(size_t capacity, bool huge_pages = false);
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+  /**
+   * \warning Все буферы должны быть возвращены до уничтожения пула.
+   */
+  ~BufferPool();
+
+  /**
+   * \brief Взять свободный буфер или выделить новый.
+   */
+  Buffer Borrow();
+  /**
+   * \brief Освободить память свободных буферов.
+   */
+  void Trim();
+  [[nodiscard]] size_t GetCapacity() const;
+  /**
+   * \brief Получить количество выделенных пулом буферов, включая взятые.
+   */
+  [[nodiscard]] size_t GetAllocatedCount() const;
+  /**
+   * \brief Получить наибольшее количество одновременно выделенных пулом буферов.
+   */
+  [[nodiscard]] size_t GetPeakAllocatedCount() const;
+
+ private:
+  const size_t capacity_;
+  const size_t alignment_;
+  const bool huge_pages_;
+  std::vector<Value *> free_;
+  size_t allocated_count_ = 0;
+  size_t peak_allocated_count_ = 0;
+  mutable std::mutex mutex_;
+
+  Value *Allocate() const;
+  void Free(Value *data) const;
+  void Return(Value *data);
+};
+
+template <typename Value>
+BufferPool<Value>::Buffer::Buffer(BufferPool &pool, Value *data) : pool_(&pool), data_(data) {
+}
+
+template <typename Value>
+BufferPool<Value>::Buffer::Buffer(Buffer &&other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)), data_(std::exchange(other.data_, nullptr)) {
+}
+
+template <typename Value>
+auto BufferPool<Value>::Buffer::operator=(Buffer &&other) noexcept -> Buffer & {
+  if (this != &other) {
+    Return();
+    pool_ = std::exchange(other.pool_, nullptr);
+    data_ = std::exchange(other.data_, nullptr);
+  }
+  return *this;
+}
+
+template <typename Value>
+BufferPool<Value>::Buffer::~Buffer() {
+  Return();
+}
+
+template <typename Value>
+std::span<Value> BufferPool<Value>::Buffer::Get() const {
+  return pool_ ? std::span(data_, pool_->capacity_) : std::span<Value>();
+}
+
+template <typename Value>
+void BufferPool<Value>::Buffer::Return() {
+  if (pool_) {
+    pool_->Return(std::exchange(data_, nullptr));
+    pool_ = nullptr;
+  }
+}
+
+template <typename Value>
+BufferPool<Value>::BufferPool(const size_t capacity, const bool huge_pages)
+    : capacity_(capacity),
+      alignment_(
+          huge_pages && capacity * sizeof(Value) >= kHugePageSize ? kHugePageSize : kAlignment
+      ),
+      huge_pages_(alignment_ == kHugePageSize) {
+  if (capacity == 0) {
+    throw std::invalid_argument("Buffer capacity must be positive.");
+  }
+}
+
+template <typename Value>
+BufferPool<Value>::~BufferPool() {
+  Trim();
+}
+
+template <typename Value>
+auto BufferPool<Value>::Borrow() -> Buffer {
+  {
+    std::lock_guard lock(mutex_);
+    if (!free_.empty()) {
+      Value *const data = free_.back();
+      free_.pop_back();
+      return {*this, data};
+    }
+  }
+  Value *const data = Allocate();
+  std::lock_guard lock(mutex_);
+  peak_allocated_count_ = std::max(peak_allocated_count_, ++allocated_count_);
+  return {*this, data};
+}
+
+template <typename Value>
+void BufferPool<Value>::Trim() {
+  std::vector<Value *> free;
+  {
+    std::lock_guard lock(mutex_);
+    free.swap(free_);
+    allocated_count_ -= free.size();
+  }
+  for (Value *const data : free) {
+    Free(data);
+  }
+}
+
+template <typename Value>
+size_t BufferPool<Value>::GetCapacity() const {
+  return capacity_;
+}
+
+template <typename Value>
+size_t BufferPool<Value>::GetAllocatedCount() const {
+  std::lock_guard lock(mutex_);
+  return allocated_count_;
+}
+
+template <typename Value>
+size_t BufferPool<Value>::GetPeakAllocatedCount() const {
+  std::lock_guard lock(mutex_);
+  return peak_allocated_count_;
+}
+
+template <typename Value>
+Value *BufferPool<Value>::Allocate() const {
+  const auto size = capacity_ * sizeof(Value);
+  // размер кратен выравниванию, чтобы соседние буферы не делили страницы
+  const auto aligned_size = (size + alignment_ - 1) / alignment_ * alignment_;
+  void *const memory = ::operator new(aligned_size, std::align_val_t(alignment_));
+  if (huge_pages_) {
+    // это лишь подсказка ядру, поэтому ошибка не критична
+    madvise(memory, aligned_size, MADV_HUGEPAGE);
+  }
+  auto *const data = static_cast<Value *>(memory);
+  std::uninitialized_default_construct_n(data, capacity_);
+  return data;
+}
+
+template <typename Value>
+void BufferPool<Value>::Free(Value *const data) const {
+  std::destroy_n(data, capacity_);
+  ::operator delete(data, std::align_val_t(alignment_));
+}
+
+template <typename Value>
+void BufferPool<Value>::Return(Value *const data) {
+  std::lock_guard lock(mutex_);
+  free_.push_back(data);
+}
+
+}  // namespace sot::core
+
+#endif  // BUFFER_POOL_H
@@ -0,0 +1,64 @@
+#ifndef IO_EXECUTOR_H
+#define IO_EXECUTOR_H
+
+#include <future>
+#include <memory>
+#include <type_traits>
+
+#include "thread_pool.h"
+
+namespace sot::core {
+
+/**
+ * \brief Ограниченный набор потоков для фонового ввода-вывода лент.
+ *
+ * Отложенная запись и упреждающее чтение отправляют операции сюда, а не запускают по потоку на
+ * каждый блок, поэтому количество потоков ввода-вывода не превышает заданного. Потоки отделены от
+ * пула сортировки: его задачи ждут завершения операций, и в общем пуле они могли бы ждать сами
+ * себя.
+ */
+class IoExecutor {
+ public:
+  /**
+   * \param max_thread_count наибольшее количество потоков ввода-вывода.
+   */
+  explicit IoExecutor(size_t max_thread_count);
+  IoExecutor(const IoExecutor &) = delete;
+  IoExecutor &operator=(const IoExecutor &) = delete;
+  /**
+   * \warning Завершения всех операций нужно дождаться до уничтожения, так как еще не начатые
+   * операции отменяются.
+   */
+  ~IoExecutor() = default;
+
+  /**
+   * \brief Выполнить операцию в фоне.
+   *
+   * \return результат операции, исключение операции пробрасывается из него.
+   */
+  template <typename Operation>
+  std::future<std::invoke_result_t<Operation>> Submit(Operation operation);
+
+ private:
+  ThreadPool thread_pool_;
+};
+
+inline IoExecutor::IoExecutor(const size_t max_thread_count) : thread_pool_(max_thread_count) {
+}
+
+template <typename Operation>
+std::future<std::invoke_result_t<Operation>> IoExecutor::Submit(Operation operation) {
+  // задача пула должна копироваться, поэтому перемещаемая packaged_task разделяется
+  const auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Operation>()>>(
+      std::move(operation)
+  );
+  auto result = task->get_future();
+  thread_pool_.PostTask([task] {
+    (*task)();
+  });
+  return result;
+}
+
+}  // namespace sot::core
+
+#endif  // IO_EXECUTOR_H
@@ -0,0 +1,351 @@
+#include "io_queue.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace sot::core {
+
+namespace {
+
+/// Пауза перед повторной отправкой, если ядру не хватает ресурсов, а ждать завершения нечего.
+constexpr auto kRetryDelay = std::chrono::microseconds(100);
+
+/**
+ * \brief Прочитать size байт по смещению offset через pread, повторяя короткие чтения.
+ * \return количество прочитанных байт (меньше size только в конце файла) либо -errno.
+ */
+ssize_t ReadAt(const int fd, void *buffer, const size_t size, const off_t offset) {
+  size_t done = 0;
+  while (done < size) {
+    const auto read = pread(
+        fd, static_cast<std::byte *>(buffer) + done, size - done, offset + static_cast<off_t>(done)
+    );
+    if (read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (read < 0) {
+      return -errno;
+    }
+    if (read == 0) {
+      break;
+    }
+    done += static_cast<size_t>(read);
+  }
+  return static_cast<ssize_t>(done);
+}
+
+/**
+ * \brief Записать size байт по смещению offset через pwrite, повторяя короткие записи.
+ * \return количество записанных байт либо -errno.
+ */
+ssize_t WriteAt(const int fd, const void *buffer, const size_t size, const off_t offset) {
+  size_t done = 0;
+  while (done < size) {
+    const auto written = pwrite(
+        fd,
+        static_cast<const std::byte *>(buffer) + done,
+        size - done,
+        offset + static_cast<off_t>(done)
+    );
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      return -errno;
+    }
+    done += static_cast<size_t>(written);
+  }
+  return static_cast<ssize_t>(done);
+}
+
+/**
+ * \brief Синхронное выполнение операций через pread/pwrite.
+ */
+class SyncIoQueue : public IoQueue {
+ public:
+  void SubmitRead(int fd, void *buffer, size_t size, off_t offset, uint64_t tag) override;
+  void SubmitWrite(int fd, const void *buffer, size_t size, off_t offset, uint64_t tag) override;
+  ssize_t Wait(uint64_t tag) override;
+  [[nodiscard]] Kind GetKind() const override;
+};
+
+/**
+ * \brief Асинхронное выполнение операций через io_uring без использования liburing.
+ *
+ * Кольцо используется, только если ядро поддерживает IORING_OP_READ и IORING_OP_WRITE (до Linux
+ * 5.6 кольцо создается, но эти операции отклоняются). Поддержка проверяется один раз при
+ * создании, поэтому ошибки отдельных операций, в том числе EINVAL, возвращаются вызывающему.
+ *
+ * Одновременно выполняется не больше операций, чем вмещает кольцо отправки: следующая операция
+ * отправляется после завершения одной из выполняемых, поэтому кольцо завершений, вдвое большее,
+ * не переполняется.
+ */
+class IoUringQueue : public IoQueue {
+ public:
+  /**
+   * \brief Создать кольца io_uring.
+   * \return nullptr - если io_uring недоступен или не поддерживает операции чтения и записи.
+   */
+  static std::unique_ptr<IoUringQueue> Create(size_t depth);
+
+  IoUringQueue(const IoUringQueue &other) = delete;
+  IoUringQueue &operator=(const IoUringQueue &other) = delete;
+  ~IoUringQueue() override;
+
+  void SubmitRead(int fd, void *buffer, size_t size, off_t offset, uint64_t tag) override;
+  void SubmitWrite(int fd, const void *buffer, size_t size, off_t offset, uint64_t tag) override;
+  ssize_t Wait(uint64_t tag) override;
+  [[nodiscard]] Kind GetKind() const override;
+
+ private:
+  /// Отображение кольца в память.
+  struct Mapping {
+    void *data = MAP_FAILED;
+    size_t size = 0;
+  };
+
+  int ring_fd_ = -1;
+  Mapping sq_mapping_;
+  Mapping cq_mapping_;
+  Mapping sqes_mapping_;
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned *sq_array_ = nullptr;
+  io_uring_sqe *sqes_ = nullptr;
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe *cqes_ = nullptr;
+  /// Количество отправленных операций, результаты которых еще не забраны из кольца завершений.
+  size_t in_flight_ = 0;
+
+  IoUringQueue() = default;
+
+  /**
+   * \brief Поддерживает ли ядро операции чтения и записи кольца.
+   */
+  [[nodiscard]] bool SupportsReadWrite() const;
+
+  void Submit(uint8_t opcode, int fd, const void *buffer, size_t size, off_t offset, uint64_t tag);
+  /**
+   * \brief Забрать все готовые результаты из кольца завершений.
+   */
+  void Reap();
+  /**
+   * \brief Дождаться завершения хотя бы одной операции и забрать результаты.
+   */
+  void WaitForCompletion();
+};
+
+template <typename T>
+T *At(const void *base, const unsigned offset) {
+  return reinterpret_cast<T *>(static_cast<std::byte *>(const_cast<void *>(base)) + offset);
+}
+
+}  // namespace
+
+std::unique_ptr<IoQueue> IoQueue::Create(const size_t depth, const Kind kind) {
+  if (kind == Kind::kIoUring) {
+    if (auto queue = IoUringQueue::Create(depth)) {
+      return queue;
+    }
+  }
+  return std::make_unique<SyncIoQueue>();
+}
+
+void SyncIoQueue::SubmitRead(
+    const int fd, void *buffer, const size_t size, const off_t offset, const uint64_t tag
+) {
+  completed_[tag] = ReadAt(fd, buffer, size, offset);
+}
+
+void SyncIoQueue::SubmitWrite(
+    const int fd, const void *buffer, const size_t size, const off_t offset, const uint64_t tag
+) {
+  completed_[tag] = WriteAt(fd, buffer, size, offset);
+}
+
+ssize_t SyncIoQueue::Wait(const uint64_t tag) {
+  const auto result = completed_.extract(tag);
+  if (result.empty()) {
+    throw std::logic_error("There is no submitted operation with the given tag.");
+  }
+  return result.mapped();
+}
+
+IoQueue::Kind SyncIoQueue::GetKind() const {
+  return Kind::kSync;
+}
+
+std::unique_ptr<IoUringQueue> IoUringQueue::Create(const size_t depth) {
+  io_uring_params params{};
+  const auto ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+  if (ring_fd < 0) {
+    return nullptr;
+  }
+  std::unique_ptr<IoUringQueue> queue(new IoUringQueue());
+  queue->ring_fd_ = ring_fd;
+
+  const auto map = [ring_fd](Mapping &mapping, const size_t size, const off_t offset) {
+    mapping.size = size;
+    mapping.data =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+    return mapping.data != MAP_FAILED;
+  };
+  const auto sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  const auto cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const auto sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  if (!map(queue->sq_mapping_, sq_size, IORING_OFF_SQ_RING) ||
+      !map(queue->cq_mapping_, cq_size, IORING_OFF_CQ_RING) ||
+      !map(queue->sqes_mapping_, sqes_size, IORING_OFF_SQES)) {
+    return nullptr;
+  }
+
+  const auto *sq = queue->sq_mapping_.data;
+  queue->sq_head_ = At<unsigned>(sq, params.sq_off.head);
+  queue->sq_tail_ = At<unsigned>(sq, params.sq_off.tail);
+  queue->sq_mask_ = *At<unsigned>(sq, params.sq_off.ring_mask);
+  queue->sq_entries_ = params.sq_entries;
+  queue->sq_array_ = At<unsigned>(sq, params.sq_off.array);
+  queue->sqes_ = static_cast<io_uring_sqe *>(queue->sqes_mapping_.data);
+  const auto *cq = queue->cq_mapping_.data;
+  queue->cq_head_ = At<unsigned>(cq, params.cq_off.head);
+  queue->cq_tail_ = At<unsigned>(cq, params.cq_off.tail);
+  queue->cq_mask_ = *At<unsigned>(cq, params.cq_off.ring_mask);
+  queue->cqes_ = At<io_uring_cqe>(cq, params.cq_off.cqes);
+  if (!queue->SupportsReadWrite()) {
+    return nullptr;
+  }
+  return queue;
+}
+
+IoUringQueue::~IoUringQueue() {
+  for (auto *mapping : {&sqes_mapping_, &cq_mapping_, &sq_mapping_}) {
+    if (mapping->data != MAP_FAILED) {
+      munmap(mapping->data, mapping->size);
+    }
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+void IoUringQueue::SubmitRead(
+    const int fd, void *buffer, const size_t size, const off_t offset, const uint64_t tag
+) {
+  Submit(IORING_OP_READ, fd, buffer, size, offset, tag);
+}
+
+void IoUringQueue::SubmitWrite(
+    const int fd, const void *buffer, const size_t size, const off_t offset, const uint64_t tag
+) {
+  Submit(IORING_OP_WRITE, fd, buffer, size, offset, tag);
+}
+
+ssize_t IoUringQueue::Wait(const uint64_t tag) {
+  Reap();
+  while (true) {
+    if (const auto result = completed_.extract(tag); !result.empty()) {
+      return result.mapped();
+    }
+    if (in_flight_ == 0) {
+      throw std::logic_error("There is no submitted operation with the given tag.");
+    }
+    WaitForCompletion();
+  }
+}
+
+IoQueue::Kind IoUringQueue::GetKind() const {
+  return Kind::kIoUring;
+}
+
+bool IoUringQueue::SupportsReadWrite() const {
+  // проверка поддержки операций появилась в ядре вместе с IORING_OP_READ и IORING_OP_WRITE, поэтому
+  // ее ошибка означает, что они не поддерживаются
+  constexpr size_t kOpCount = IORING_OP_LAST;
+  std::vector<std::byte> memory(sizeof(io_uring_probe) + kOpCount * sizeof(io_uring_probe_op));
+  auto *probe = reinterpret_cast<io_uring_probe *>(memory.data());
+  if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe, kOpCount) < 0) {
+    return false;
+  }
+  const auto supported = [probe](const uint8_t opcode) {
+    return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+  };
+  return supported(IORING_OP_READ) && supported(IORING_OP_WRITE);
+}
+
+void IoUringQueue::Submit(
+    const uint8_t opcode,
+    const int fd,
+    const void *buffer,
+    const size_t size,
+    const off_t offset,
+    const uint64_t tag
+) {
+  const auto tail = std::atomic_ref(*sq_tail_).load(std::memory_order_relaxed);
+  // вызывающий может отправить больше операций, чем вмещает кольцо, поэтому место под новую
+  // освобождается завершением одной из выполняемых
+  while (in_flight_ >= sq_entries_ ||
+         tail - std::atomic_ref(*sq_head_).load(std::memory_order_acquire) >= sq_entries_) {
+    WaitForCompletion();
+  }
+  const auto index = tail & sq_mask_;
+  auto &sqe = sqes_[index];
+  sqe = {};
+  sqe.opcode = opcode;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<uint64_t>(buffer);
+  sqe.len = static_cast<uint32_t>(size);
+  sqe.off = static_cast<uint64_t>(offset);
+  sqe.user_data = tag;
+  sq_array_[index] = index;
+  std::atomic_ref(*sq_tail_).store(tail + 1, std::memory_order_release);
+  ++in_flight_;
+  while (syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, 0, 0) < 0) {
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN) {
+      throw std::runtime_error("Couldn't submit the io_uring request.");
+    }
+    // ядру не хватает ресурсов на новый запрос: они освобождаются завершением уже выполняемых
+    // операций, а если таких нет, повторная отправка откладывается, чтобы не занимать процессор
+    if (in_flight_ > 1) {
+      WaitForCompletion();
+    } else {
+      std::this_thread::sleep_for(kRetryDelay);
+    }
+  }
+}
+
+void IoUringQueue::Reap() {
+  auto head = std::atomic_ref(*cq_head_).load(std::memory_order_relaxed);
+  const auto tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+  for (; head != tail; ++head) {
+    const auto &cqe = cqes_[head & cq_mask_];
+    completed_[cqe.user_data] = cqe.res;
+    --in_flight_;
+  }
+  std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+}
+
+void IoUringQueue::WaitForCompletion() {
+  const auto entered = syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, 0, 0);
+  if (entered < 0 && errno != EINTR && errno != EAGAIN) {
+    throw std::runtime_error("Couldn't wait for the io_uring completion.");
+  }
+  Reap();
+}
+
+}  // namespace sot::core
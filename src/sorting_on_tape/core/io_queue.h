@@ -0,0 +1,65 @@
+#ifndef IO_QUEUE_H
+#define IO_QUEUE_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace sot::core {
+
+/**
+ * \brief Очередь асинхронных операций чтения и записи по смещению в файле.
+ *
+ * Операции отправляются с тегом, по которому затем ожидается их завершение. Если ядро не
+ * поддерживает io_uring (или его использование запрещено), операции выполняются синхронно через
+ * pread/pwrite в момент отправки, а ожидание сразу возвращает сохраненный результат.
+ *
+ * \warning Очередь не потокобезопасна.
+ */
+class IoQueue {
+ public:
+  /// Способ выполнения операций.
+  enum class Kind {
+    /// Асинхронно через io_uring.
+    kIoUring,
+    /// Синхронно через pread/pwrite.
+    kSync,
+  };
+
+  /**
+   * \brief Создать очередь.
+   *
+   * \param depth максимальное количество одновременно выполняемых операций, отправка следующей
+   * дожидается завершения одной из них;
+   * \param kind предпочтительный способ выполнения операций, при недоступности io_uring
+   * используется синхронный.
+   */
+  static std::unique_ptr<IoQueue> Create(size_t depth, Kind kind = Kind::kIoUring);
+
+  virtual ~IoQueue() = default;
+
+  /**
+   * \brief Отправить операцию чтения size байт по смещению offset.
+   */
+  virtual void SubmitRead(int fd, void *buffer, size_t size, off_t offset, uint64_t tag) = 0;
+  /**
+   * \brief Отправить операцию записи size байт по смещению offset.
+   */
+  virtual void SubmitWrite(int fd, const void *buffer, size_t size, off_t offset, uint64_t tag) = 0;
+  /**
+   * \brief Дождаться завершения операции с заданным тегом.
+   * \return количество прочитанных или записанных байт либо -errno в случае ошибки.
+   */
+  virtual ssize_t Wait(uint64_t tag) = 0;
+  [[nodiscard]] virtual Kind GetKind() const = 0;
+
+ protected:
+  /// Результаты завершенных, но еще не ожидаемых операций.
+  std::unordered_map<uint64_t, ssize_t> completed_;
+};
+
+}  // namespace sot::core
+
+#endif  // IO_QUEUE_H
@@ -0,0 +1,83 @@
+#include "memory_governor.h"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+namespace sot::core {
+
+MemoryGovernor::Reservation::Reservation(MemoryGovernor &governor, const size_t size)
+    : governor_(&governor), size_(size) {
+}
+
+MemoryGovernor::Reservation::Reservation(Reservation &&other) noexcept
+    : governor_(std::exchange(other.governor_, nullptr)), size_(std::exchange(other.size_, 0)) {
+}
+
+MemoryGovernor::Reservation &MemoryGovernor::Reservation::operator=(Reservation &&other) noexcept {
+  if (this != &other) {
+    Release();
+    governor_ = std::exchange(other.governor_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MemoryGovernor::Reservation::~Reservation() {
+  Release();
+}
+
+size_t MemoryGovernor::Reservation::GetSize() const {
+  return size_;
+}
+
+void MemoryGovernor::Reservation::Release() {
+  if (governor_) {
+    governor_->Release(size_);
+    governor_ = nullptr;
+    size_ = 0;
+  }
+}
+
+MemoryGovernor::MemoryGovernor(const size_t limit) : limit_(limit), available_(limit) {
+}
+
+MemoryGovernor::Reservation MemoryGovernor::Reserve(const size_t size) {
+  if (size > limit_) {
+    throw std::invalid_argument(
+        std::format("Can't reserve {} bytes with memory limit {} bytes.", size, limit_)
+    );
+  }
+  std::unique_lock lock(mutex_);
+  released_.wait(lock, [this, size]() {
+    return available_ >= size;
+  });
+  available_ -= size;
+  return {*this, size};
+}
+
+std::optional<MemoryGovernor::Reservation> MemoryGovernor::TryReserve(const size_t size) {
+  std::lock_guard lock(mutex_);
+  if (available_ < size) {
+    return std::nullopt;
+  }
+  available_ -= size;
+  return Reservation(*this, size);
+}
+
+size_t MemoryGovernor::GetLimit() const {
+  return limit_;
+}
+
+size_t MemoryGovernor::GetAvailable() const {
+  std::lock_guard lock(mutex_);
+  return available_;
+}
+
+void MemoryGovernor::Release(const size_t size) {
+  std::lock_guard lock(mutex_);
+  available_ += size;
+  released_.notify_all();
+}
+
+}  // namespace sot::core
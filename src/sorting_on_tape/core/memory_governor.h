@@ -0,0 +1,77 @@
+#ifndef MEMORY_GOVERNOR_H
+#define MEMORY_GOVERNOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+namespace sot::core {
+
+/**
+ * \brief Общий бюджет памяти, из которого резервируется место под каждый буфер.
+ *
+ * Резервирование блокируется, пока в бюджете не освободится нужный объем, поэтому суммарный размер
+ * одновременно существующих резервов никогда не превышает лимита.
+ */
+class MemoryGovernor {
+ public:
+  /**
+   * \brief Зарезервированная память, возвращаемая в бюджет при уничтожении.
+   */
+  class Reservation {
+   public:
+    Reservation() = default;
+    Reservation(Reservation &&other) noexcept;
+    Reservation &operator=(Reservation &&other) noexcept;
+    ~Reservation();
+
+    /**
+     * \brief Получить размер резерва в байтах.
+     */
+    [[nodiscard]] size_t GetSize() const;
+    /**
+     * \brief Досрочно вернуть память в бюджет.
+     */
+    void Release();
+
+   private:
+    friend class MemoryGovernor;
+
+    MemoryGovernor *governor_ = nullptr;
+    size_t size_ = 0;
+
+    Reservation(MemoryGovernor &governor, size_t size);
+  };
+
+  explicit MemoryGovernor(size_t limit);
+  MemoryGovernor(const MemoryGovernor &) = delete;
+  MemoryGovernor &operator=(const MemoryGovernor &) = delete;
+
+  /**
+   * \brief Зарезервировать память, дождавшись ее освобождения.
+   * \throws std::invalid_argument если размер превышает лимит.
+   */
+  Reservation Reserve(size_t size);
+  /**
+   * \brief Зарезервировать память, только если она доступна сейчас.
+   */
+  std::optional<Reservation> TryReserve(size_t size);
+  [[nodiscard]] size_t GetLimit() const;
+  /**
+   * \brief Получить объем памяти, не занятый резервами.
+   */
+  [[nodiscard]] size_t GetAvailable() const;
+
+ private:
+  const size_t limit_;
+  size_t available_;
+  mutable std::mutex mutex_;
+  std::condition_variable released_;
+
+  void Release(size_t size);
+};
+
+}  // namespace sot::core
+
+#endif  // MEMORY_GOVERNOR_H
@@ -0,0 +1,77 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace sot::core {
+
+/**
+ * \brief Выполнить задачи с индексами [0, task_count) вызывающим потоком и свободными потоками
+ * пула.
+ *
+ * В пул отправляются worker_count - 1 помощников, которые, как и вызывающий поток, забирают
+ * очередные индексы из общего счетчика. Вызывающий поток не простаивает в ожидании помощников:
+ * он ждет только завершения уже начатых ими задач, поэтому вызов из задачи пула не приводит к
+ * взаимной блокировке, даже если все потоки пула заняты. Помощники, запущенные после разбора всех
+ * индексов, сразу завершаются.
+ *
+ * \tparam ThreadPool пул потоков с методом PostTask.
+ * \param body задача, принимающая индекс; исключение первой упавшей задачи пробрасывается
+ * вызывающему потоку после завершения остальных.
+ */
+template <typename ThreadPool>
+void ParallelFor(
+    ThreadPool &thread_pool,
+    const size_t task_count,
+    const size_t worker_count,
+    const std::function<void(size_t)> &body
+) {
+  struct State {
+    std::atomic_size_t next = 0;
+    size_t done = 0;
+    std::exception_ptr exception;
+    std::mutex mutex;
+    std::condition_variable all_done;
+  };
+  // помощники могут запуститься уже после возврата, поэтому состояние разделяется с ними, а body
+  // вызывается только для индексов, завершения которых дожидается вызывающий поток
+  const auto state = std::make_shared<State>();
+  const auto work = [state, task_count, &body]() {
+    for (auto task = state->next++; task < task_count; task = state->next++) {
+      std::exception_ptr exception;
+      try {
+        body(task);
+      } catch (...) {
+        exception = std::current_exception();
+      }
+      std::lock_guard lock(state->mutex);
+      if (exception && !state->exception) {
+        state->exception = exception;
+      }
+      if (++state->done == task_count) {
+        state->all_done.notify_all();
+      }
+    }
+  };
+  for (size_t i = 1; i < std::min(worker_count, task_count); ++i) {
+    thread_pool.PostTask(work);
+  }
+  work();
+  std::unique_lock lock(state->mutex);
+  state->all_done.wait(lock, [&state, task_count]() {
+    return state->done == task_count;
+  });
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+}  // namespace sot::core
+
+#endif  // PARALLEL_FOR_H
@@ -0,0 +1,154 @@
+#include "simd_sort.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <array>
+
+namespace sot::core {
+
+namespace {
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace avx2 {
+
+/**
+ * \brief Операции над 256-битным регистром из 8 ключей.
+ */
+struct Ops {
+  using Vector = __m256i;
+  static constexpr size_t kLanes = 8;
+
+  static Vector Load(const std::int32_t *keys) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys));
+  }
+  static void Store(std::int32_t *keys, const Vector v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(keys), v);
+  }
+  static Vector Min(const Vector a, const Vector b) {
+    return _mm256_min_epi32(a, b);
+  }
+  static Vector Max(const Vector a, const Vector b) {
+    return _mm256_max_epi32(a, b);
+  }
+  static Vector Permute(const Vector v, const Vector indices) {
+    return _mm256_permutevar8x32_epi32(v, indices);
+  }
+  static Vector Select(const Vector mask, const Vector a, const Vector b) {
+    return _mm256_blendv_epi8(a, b, mask);
+  }
+};
+
+#include "simd_sort_kernel.h"
+
+}  // namespace avx2
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// GCC 12 ложно предупреждает о _mm512_undefined_epi32 внутри встроенных функций (GCC PR105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+namespace avx512 {
+
+/**
+ * \brief Операции над 512-битным регистром из 16 ключей.
+ */
+struct Ops {
+  using Vector = __m512i;
+  static constexpr size_t kLanes = 16;
+
+  static Vector Load(const std::int32_t *keys) {
+    return _mm512_loadu_si512(keys);
+  }
+  static void Store(std::int32_t *keys, const Vector v) {
+    _mm512_storeu_si512(keys, v);
+  }
+  static Vector Min(const Vector a, const Vector b) {
+    return _mm512_min_epi32(a, b);
+  }
+  static Vector Max(const Vector a, const Vector b) {
+    return _mm512_max_epi32(a, b);
+  }
+  static Vector Permute(const Vector v, const Vector indices) {
+    return _mm512_permutexvar_epi32(indices, v);
+  }
+  static Vector Select(const Vector mask, const Vector a, const Vector b) {
+    return _mm512_mask_blend_epi32(_mm512_test_epi32_mask(mask, mask), a, b);
+  }
+};
+
+#include "simd_sort_kernel.h"
+
+}  // namespace avx512
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+/**
+ * \brief Влить отсортированный хвост, меньший длины регистра, в отсортированное начало.
+ */
+void MergeTail(std::span<std::int32_t> keys, const size_t head_size) {
+  const auto tail = keys.subspan(head_size);
+  std::sort(tail.begin(), tail.end());
+  std::array<std::int32_t, avx512::kLanes> buffer{};
+  std::ranges::copy(tail, buffer.begin());
+  // слияние с конца, чтобы сдвигать только ключи начала, большие ключей хвоста
+  auto head = head_size;
+  auto left = tail.size();
+  auto out = keys.size();
+  while (left > 0) {
+    if (head > 0 && keys[head - 1] > buffer[left - 1]) {
+      keys[--out] = keys[--head];
+    } else {
+      keys[--out] = buffer[--left];
+    }
+  }
+}
+
+}  // namespace
+
+SimdIsa GetSupportedSimdIsa() {
+  static const auto isa = [] {
+    if (__builtin_cpu_supports("avx512f")) {
+      return SimdIsa::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdIsa::kAvx2;
+    }
+    return SimdIsa::kScalar;
+  }();
+  return isa;
+}
+
+void SortKeys(
+    const std::span<std::int32_t> keys, const std::span<std::int32_t> scratch, SimdIsa isa
+) {
+  if (scratch.size() < keys.size()) {
+    throw std::invalid_argument("The scratch buffer is smaller than the keys to sort.");
+  }
+  isa = std::min(isa, GetSupportedSimdIsa());
+  size_t head_size = 0;
+  switch (isa) {
+    case SimdIsa::kAvx512:
+      head_size = keys.size() - keys.size() % avx512::kLanes;
+      avx512::SortKeys(keys.data(), scratch.data(), head_size);
+      break;
+    case SimdIsa::kAvx2:
+      head_size = keys.size() - keys.size() % avx2::kLanes;
+      avx2::SortKeys(keys.data(), scratch.data(), head_size);
+      break;
+    case SimdIsa::kScalar:
+      std::sort(keys.begin(), keys.end());
+      return;
+  }
+  if (head_size < keys.size()) {
+    MergeTail(keys, head_size);
+  }
+}
+
+}  // namespace sot::core
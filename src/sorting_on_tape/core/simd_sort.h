@@ -0,0 +1,165 @@
+#ifndef SIMD_SORT_H
+#define SIMD_SORT_H
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <stdexcept>
+
+namespace sot::core {
+
+/// Набор векторных инструкций, используемый сортировкой.
+enum class SimdIsa {
+  /// Без векторных инструкций: std::sort.
+  kScalar,
+  /// 256-битные регистры AVX2.
+  kAvx2,
+  /// 512-битные регистры AVX-512F.
+  kAvx512,
+};
+
+/**
+ * \brief Определить наиболее широкий набор инструкций, поддерживаемый процессором.
+ */
+SimdIsa GetSupportedSimdIsa();
+
+/**
+ * \brief Отсортировать 32-битные знаковые ключи по возрастанию.
+ *
+ * Каждый вектор сортируется битонической сетью внутри регистра, после чего отсортированные
+ * векторы попарно сливаются слиянием в регистрах по схеме снизу вверх, используя вспомогательный
+ * буфер. Остаток, не кратный длине вектора, сортируется отдельно и вливается в конец. Поскольку
+ * у ключей нет различимых равных значений, результат совпадает побитово для любого набора
+ * инструкций.
+ *
+ * \param keys сортируемые ключи;
+ * \param scratch вспомогательный буфер не меньшего размера, его содержимое не сохраняется;
+ * \param isa набор инструкций, не поддерживаемый процессором набор заменяется на поддерживаемый.
+ */
+void SortKeys(
+    std::span<std::int32_t> keys,
+    std::span<std::int32_t> scratch,
+    SimdIsa isa = GetSupportedSimdIsa()
+);
+
+/**
+ * \brief Векторная сортировка 32-битных чисел стандартными компараторами.
+ *
+ * Значения отображаются в знаковые ключи с тем же порядком (у отрицательных чисел с плавающей
+ * точкой инвертируются все биты, при сортировке по убыванию инвертируется весь ключ), которые
+ * сортируются @link SortKeys @endlink и отображаются обратно. Числа с плавающей точкой тем самым
+ * упорядочиваются полностью: -0.0 предшествует 0.0.
+ *
+ * \tparam Value тип сортируемых значений.
+ * \tparam Comparator компаратор, задающий порядок сортировки.
+ */
+template <typename Value, typename Comparator = std::less<Value>>
+class SimdSorter {
+ public:
+  /// Можно ли отсортировать значения векторно, не нарушив порядок компаратора.
+  static constexpr bool kApplicable =
+      (std::same_as<Value, std::int32_t> || std::same_as<Value, std::uint32_t> ||
+       std::same_as<Value, float>) &&
+      (std::same_as<Comparator, std::less<Value>> || std::same_as<Comparator, std::less<>> ||
+       std::same_as<Comparator, std::greater<Value>> || std::same_as<Comparator, std::greater<>>);
+
+  /**
+   * \brief Отсортировать значения.
+   *
+   * \param values сортируемые значения;
+   * \param scratch вспомогательный буфер не меньшего размера, его содержимое не сохраняется;
+   * \param isa набор используемых инструкций.
+   */
+  static void Sort(
+      std::span<Value> values, std::span<Value> scratch, SimdIsa isa = GetSupportedSimdIsa()
+  )
+    requires kApplicable;
+
+ private:
+  static constexpr bool kDescending =
+      std::same_as<Comparator, std::greater<Value>> || std::same_as<Comparator, std::greater<>>;
+  static constexpr std::uint32_t kSignBit = 1U << 31;
+
+  /**
+   * \brief Отобразить значение в ключ, порядок которого совпадает с порядком компаратора.
+   */
+  static std::int32_t ToKey(Value value);
+  /**
+   * \brief Восстановить значение по ключу.
+   */
+  static Value FromKey(std::int32_t key);
+  /**
+   * \brief Представить буфер значений как буфер ключей того же размера.
+   */
+  static std::span<std::int32_t> AsKeys(std::span<Value> values);
+};
+
+template <typename Value, typename Comparator>
+void SimdSorter<Value, Comparator>::Sort(
+    std::span<Value> values, std::span<Value> scratch, const SimdIsa isa
+)
+  requires kApplicable
+{
+  if (scratch.size() < values.size()) {
+    throw std::invalid_argument("The scratch buffer is smaller than the values to sort.");
+  }
+  constexpr bool transform = !std::same_as<Value, std::int32_t> || kDescending;
+  if constexpr (transform) {
+    for (auto &value : values) {
+      const auto key = ToKey(value);
+      std::memcpy(&value, &key, sizeof(key));
+    }
+  }
+  SortKeys(AsKeys(values), AsKeys(scratch), isa);
+  if constexpr (transform) {
+    for (auto &value : values) {
+      std::int32_t key;
+      std::memcpy(&key, &value, sizeof(key));
+      value = FromKey(key);
+    }
+  }
+}
+
+template <typename Value, typename Comparator>
+std::int32_t SimdSorter<Value, Comparator>::ToKey(const Value value) {
+  auto key = std::bit_cast<std::uint32_t>(value);
+  if constexpr (std::same_as<Value, float>) {
+    key = (key & kSignBit) != 0 ? ~key : key | kSignBit;
+  }
+  if constexpr (!std::same_as<Value, std::int32_t>) {
+    // беззнаковый порядок ключа переводится в знаковый
+    key ^= kSignBit;
+  }
+  if constexpr (kDescending) {
+    key = ~key;
+  }
+  return std::bit_cast<std::int32_t>(key);
+}
+
+template <typename Value, typename Comparator>
+Value SimdSorter<Value, Comparator>::FromKey(const std::int32_t key) {
+  auto value = std::bit_cast<std::uint32_t>(key);
+  if constexpr (kDescending) {
+    value = ~value;
+  }
+  if constexpr (!std::same_as<Value, std::int32_t>) {
+    value ^= kSignBit;
+  }
+  if constexpr (std::same_as<Value, float>) {
+    value = (value & kSignBit) != 0 ? value & ~kSignBit : ~value;
+  }
+  return std::bit_cast<Value>(value);
+}
+
+template <typename Value, typename Comparator>
+std::span<std::int32_t> SimdSorter<Value, Comparator>::AsKeys(std::span<Value> values) {
+  static_assert(sizeof(Value) == sizeof(std::int32_t));
+  return {reinterpret_cast<std::int32_t *>(values.data()), values.size()};
+}
+
+}  // namespace sot::core
+
+#endif  // SIMD_SORT_H
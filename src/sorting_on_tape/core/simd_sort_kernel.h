@@ -0,0 +1,139 @@
+// Ядро векторной сортировки, не зависящее от набора инструкций.
+//
+// Файл намеренно не защищен от повторного включения: он включается в simd_sort.cc несколько раз,
+// каждый раз внутри своего пространства имен и области #pragma GCC target, где предварительно
+// определена структура Ops с операциями над регистром:
+//  - Vector - тип регистра, kLanes - количество 32-битных ключей в нем;
+//  - Load, Store - невыровненные загрузка и сохранение;
+//  - Min, Max - поэлементные минимум и максимум;
+//  - Permute(v, indices) - перестановка элементов регистра по индексам;
+//  - Select(mask, a, b) - элементы b там, где элемент mask не равен нулю, иначе элементы a.
+
+static constexpr size_t kLanes = Ops::kLanes;
+using Vector = typename Ops::Vector;
+
+/**
+ * \brief Один шаг битонической сети: сравнение элементов на расстоянии Distance.
+ *
+ * Внутри групп по Block элементов, с четным номером группы, меньший элемент пары остается слева,
+ * с нечетным - справа.
+ */
+template <size_t Block, size_t Distance>
+inline Vector BitonicStep(const Vector v) {
+  static constexpr auto kIndices = [] {
+    std::array<std::int32_t, kLanes> indices{};
+    for (size_t i = 0; i < kLanes; ++i) {
+      indices[i] = static_cast<std::int32_t>(i ^ Distance);
+    }
+    return indices;
+  }();
+  static constexpr auto kTakeMax = [] {
+    std::array<std::int32_t, kLanes> mask{};
+    for (size_t i = 0; i < kLanes; ++i) {
+      mask[i] = ((i & Distance) != 0) != ((i & Block) != 0) ? -1 : 0;
+    }
+    return mask;
+  }();
+  const auto partner = Ops::Permute(v, Ops::Load(kIndices.data()));
+  return Ops::Select(Ops::Load(kTakeMax.data()), Ops::Min(v, partner), Ops::Max(v, partner));
+}
+
+/**
+ * \brief Отсортировать битонические последовательности длины Block внутри регистра.
+ */
+template <size_t Block, size_t Distance = Block / 2>
+inline Vector BitonicMerge(Vector v) {
+  v = BitonicStep<Block, Distance>(v);
+  if constexpr (Distance > 1) {
+    return BitonicMerge<Block, Distance / 2>(v);
+  }
+  return v;
+}
+
+/**
+ * \brief Отсортировать регистр битонической сетью.
+ */
+template <size_t Block = 2>
+inline Vector SortVector(Vector v) {
+  v = BitonicMerge<Block>(v);
+  if constexpr (Block < kLanes) {
+    return SortVector<Block * 2>(v);
+  }
+  return v;
+}
+
+/**
+ * \brief Слить два отсортированных регистра: младшие ключи попадают в low, старшие - в high.
+ */
+inline void MergeVectors(Vector &low, Vector &high) {
+  static constexpr auto kReversed = [] {
+    std::array<std::int32_t, kLanes> indices{};
+    for (size_t i = 0; i < kLanes; ++i) {
+      indices[i] = static_cast<std::int32_t>(kLanes - 1 - i);
+    }
+    return indices;
+  }();
+  const auto reversed = Ops::Permute(high, Ops::Load(kReversed.data()));
+  const auto min = Ops::Min(low, reversed);
+  const auto max = Ops::Max(low, reversed);
+  low = BitonicMerge<kLanes>(min);
+  high = BitonicMerge<kLanes>(max);
+}
+
+/**
+ * \brief Слить две отсортированные серии, длины которых кратны длине регистра.
+ */
+inline void MergeRuns(
+    const std::int32_t *first,
+    const std::int32_t *first_end,
+    const std::int32_t *second,
+    const std::int32_t *second_end,
+    std::int32_t *out
+) {
+  auto low = Ops::Load(first);
+  auto high = Ops::Load(second);
+  first += kLanes;
+  second += kLanes;
+  MergeVectors(low, high);
+  Ops::Store(out, low);
+  out += kLanes;
+  while (first != first_end || second != second_end) {
+    // следующим сливается регистр той серии, чей первый ключ меньше
+    const bool take_first = second == second_end || (first != first_end && *first < *second);
+    auto &source = take_first ? first : second;
+    low = Ops::Load(source);
+    source += kLanes;
+    MergeVectors(low, high);
+    Ops::Store(out, low);
+    out += kLanes;
+  }
+  Ops::Store(out, high);
+}
+
+/**
+ * \brief Отсортировать ключи, количество которых кратно длине регистра.
+ */
+inline void SortKeys(std::int32_t *keys, std::int32_t *scratch, const size_t size) {
+  for (size_t i = 0; i < size; i += kLanes) {
+    Ops::Store(keys + i, SortVector(Ops::Load(keys + i)));
+  }
+  auto *source = keys;
+  auto *destination = scratch;
+  for (size_t width = kLanes; width < size; width *= 2) {
+    for (size_t begin = 0; begin < size; begin += 2 * width) {
+      const auto middle = std::min(begin + width, size);
+      const auto end = std::min(begin + 2 * width, size);
+      if (middle == end) {
+        std::copy(source + begin, source + end, destination + begin);
+      } else {
+        MergeRuns(
+            source + begin, source + middle, source + middle, source + end, destination + begin
+        );
+      }
+    }
+    std::swap(source, destination);
+  }
+  if (source != keys) {
+    std::copy(source, source + size, keys);
+  }
+}
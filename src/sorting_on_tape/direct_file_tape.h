@@ -0,0 +1,517 @@
+#ifndef DIRECT_FILE_TAPE_H
+#define DIRECT_FILE_TAPE_H
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+#include "core/io_queue.h"
+#include "memory_literals.h"
+#include "tape.h"
+#include "tape_latency.h"
+
+namespace sot {
+
+using namespace memory_literals;
+
+/**
+ * \brief Эмулятор изменяемого устройства типа ленты на основе файла, открытого с O_DIRECT.
+ *
+ * Файл читается и пишется выровненными блоками (чанками) в обход страничного кэша. Чанки хранятся
+ * в небольшом кольце буферов: при последовательном чтении следующие чанки запрашиваются заранее, а
+ * полностью записанный чанк сразу отправляется на запись, так что одновременно выполняется
+ * несколько операций. Операции выполняются через io_uring, а при его недоступности - через
+ * pread/pwrite (см. @link core::IoQueue @endlink). Если файловая система не поддерживает O_DIRECT,
+ * файл открывается обычным образом. Задержки устройства задаются как в @link TapeLatency @endlink.
+ *
+ * \tparam Value тип данных для хранения на устройстве.
+ */
+template <typename Value = int32_t>
+class DirectFileTape : public Tape<Value> {
+ public:
+  /// Тип данных для хранения на устройстве.
+  using ValueT = typename Tape<Value>::ValueT;
+  /// Вектор, состоящий из элементов.
+  using Values = typename Tape<Value>::Values;
+  /// Итератор вектора из элементов.
+  using ValuesIterator = typename Tape<Value>::ValuesIterator;
+  /// Константный итератор вектора из элементов.
+  using ValuesConstIterator = typename Tape<Value>::ValuesConstIterator;
+
+  /// Ключ в конфигурации, задающий размер чанка в байтах (кратен @link kAlignment @endlink).
+  static constexpr auto kChunkSizeKey = "direct_io_chunk_size";
+  /// Ключ в конфигурации, задающий количество буферов чанков одной ленты.
+  static constexpr auto kQueueDepthKey = "direct_io_queue_depth";
+
+  /// Значение размера чанка по умолчанию в байтах.
+  static constexpr size_t kChunkSizeDefault = 256_KiB;
+  /// Значение количества буферов чанков по умолчанию.
+  static constexpr size_t kQueueDepthDefault = 4;
+  /// Выравнивание буферов, смещений и размеров операций.
+  static constexpr size_t kAlignment = 4_KiB;
+
+  DirectFileTape(const Configuration &config, const std::string &file_name);
+  DirectFileTape(const DirectFileTape &other) = delete;
+  DirectFileTape &operator=(const DirectFileTape &other) = delete;
+  /**
+   * \brief Дожидается выполнения операций, записывает измененные чанки и обрезает файл до
+   * фактически записанного размера.
+   */
+  ~DirectFileTape() override;
+
+  /**
+   * \brief Получить объем памяти в байтах, который занимают буферы чанков ленты с заданной
+   * конфигурацией.
+   */
+  [[nodiscard]] static size_t GetBufferSize(const Configuration &config);
+
+  std::optional<Value> Read() override;
+  Values ReadN(size_t n) override;
+  size_t ReadInto(std::span<Value> values) override;
+  bool Write(const Value &value) override;
+  size_t WriteN(const Values &values) override;
+  ValuesConstIterator WriteN(ValuesConstIterator begin, ValuesConstIterator end) override;
+  size_t WriteFrom(std::span<const Value> values) override;
+  bool MoveForward() override;
+  bool MoveBackward() override;
+  void MoveToBegin() override;
+  void MoveToEnd() override;
+  [[nodiscard]] std::chrono::microseconds GetElapsedTime() const override;
+
+  /**
+   * \brief Способ выполнения операций ввода-вывода.
+   */
+  [[nodiscard]] core::IoQueue::Kind GetIoKind() const;
+
+ private:
+  /// Освобождение выровненного буфера.
+  struct FreeBuffer {
+    void operator()(std::byte *buffer) const {
+      std::free(buffer);
+    }
+  };
+
+  /// Буфер чанка.
+  struct Slot {
+    std::unique_ptr<std::byte, FreeBuffer> buffer;
+    /// Индекс чанка в файле или nullopt, если буфер свободен.
+    std::optional<size_t> chunk;
+    /// Отправлена ли операция чтения или записи буфера.
+    bool in_flight = false;
+    /// Отправлено ли чтение, то есть содержимое буфера еще не готово.
+    bool reading = false;
+    /// Есть ли в буфере не записанные в файл изменения.
+    bool dirty = false;
+  };
+
+  int fd_ = -1;
+  const size_t chunk_size_;
+  /// Фактический размер файла в байтах.
+  size_t size_ = 0;
+  /// Позиция указателя в байтах.
+  size_t pos_ = 0;
+  std::vector<Slot> slots_;
+  /// Следующий кандидат на вытеснение.
+  size_t next_victim_ = 0;
+  std::unique_ptr<core::IoQueue> io_queue_;
+  TapeLatency latency_;
+
+  /**
+   * \brief Получить количество буферов чанков ленты с заданной конфигурацией.
+   */
+  [[nodiscard]] static size_t GetQueueDepth(const Configuration &config);
+
+  size_t ReadInto_(std::span<Value> values);
+  size_t WriteFrom_(std::span<const Value> values);
+  /**
+   * \brief Получить буфер чанка для чтения, заодно запросив следующие чанки.
+   */
+  Slot &AcquireForRead(size_t chunk);
+  /**
+   * \brief Получить буфер чанка для изменения.
+   */
+  Slot &AcquireForWrite(size_t chunk);
+  Slot *Find(size_t chunk);
+  /**
+   * \brief Освободить буфер, не занятый чанками из диапазона [first, last).
+   */
+  Slot &Evict(size_t first, size_t last);
+  void SubmitRead(Slot &slot, size_t chunk);
+  void SubmitWrite(Slot &slot);
+  /**
+   * \brief Дождаться завершения операции над буфером.
+   */
+  void Complete(Slot &slot);
+  /**
+   * \brief Получить размер файла на диске, который может отличаться от размера ленты.
+   */
+  [[nodiscard]] size_t GetFileSize() const;
+  [[nodiscard]] size_t SlotIndex(const Slot &slot) const;
+};
+
+template <typename Value>
+DirectFileTape<Value>::DirectFileTape(const Configuration &config, const std::string &file_name)
+    : chunk_size_(config.GetProperty(kChunkSizeKey, kChunkSizeDefault)), latency_(config) {
+  if (chunk_size_ == 0 || chunk_size_ % kAlignment != 0) {
+    throw std::invalid_argument(
+        "Direct I/O chunk size must be a positive multiple of " + std::to_string(kAlignment) + "."
+    );
+  }
+  const auto depth = GetQueueDepth(config);
+  // все, что может выбросить исключение, создается до открытия файла, чтобы не потерять дескриптор
+  slots_.resize(depth);
+  for (auto &slot : slots_) {
+    slot.buffer.reset(static_cast<std::byte *>(std::aligned_alloc(kAlignment, chunk_size_)));
+    if (!slot.buffer) {
+      throw std::bad_alloc();
+    }
+  }
+  io_queue_ = core::IoQueue::Create(depth);
+  fd_ = open(file_name.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+  if (fd_ < 0 && errno == EINVAL) {
+    // файловая система не поддерживает O_DIRECT (например, tmpfs)
+    fd_ = open(file_name.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (fd_ < 0) {
+    throw std::invalid_argument("Couldn't open the file with name '" + file_name + "'.");
+  }
+  struct stat file_stat {};
+  if (fstat(fd_, &file_stat) != 0) {
+    close(fd_);
+    throw std::invalid_argument("Couldn't get the size of the file '" + file_name + "'.");
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+}
+
+template <typename Value>
+DirectFileTape<Value>::~DirectFileTape() {
+  try {
+    for (auto &slot : slots_) {
+      Complete(slot);
+      if (slot.dirty) {
+        SubmitWrite(slot);
+        Complete(slot);
+      }
+    }
+  } catch (...) {
+    // данные временной ленты больше не нужны, если не удалось их записать
+  }
+  // последний чанк записывается целиком
+  [[maybe_unused]] const auto result = ftruncate(fd_, static_cast<off_t>(size_));
+  close(fd_);
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::GetBufferSize(const Configuration &config) {
+  return GetQueueDepth(config) * config.GetProperty(kChunkSizeKey, kChunkSizeDefault);
+}
+
+template <typename Value>
+std::optional<Value> DirectFileTape<Value>::Read() {
+  latency_.Read(1);
+  Value value;
+  if (ReadInto_({&value, 1}) == 0) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+template <typename Value>
+auto DirectFileTape<Value>::ReadN(const size_t n) -> Values {
+  const auto left = pos_ < size_ ? (size_ - pos_) / sizeof(Value) : 0;
+  Values values(std::min(n, left));
+  values.resize(ReadInto_(values));
+  latency_.Read(values.size());
+  return values;
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::ReadInto(std::span<Value> values) {
+  const auto read = ReadInto_(values);
+  latency_.Read(read);
+  return read;
+}
+
+template <typename Value>
+bool DirectFileTape<Value>::Write(const Value &value) {
+  latency_.Write(1);
+  return WriteFrom_({&value, 1}) == 1;
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::WriteN(const Values &values) {
+  return WriteFrom(values);
+}
+
+template <typename Value>
+auto DirectFileTape<Value>::WriteN(ValuesConstIterator begin, ValuesConstIterator end)
+    -> ValuesConstIterator {
+  return begin + static_cast<std::ptrdiff_t>(WriteFrom({begin, end}));
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::WriteFrom(std::span<const Value> values) {
+  const auto written = WriteFrom_(values);
+  latency_.Write(written);
+  return written;
+}
+
+template <typename Value>
+bool DirectFileTape<Value>::MoveForward() {
+  // как и файловый поток, изменяемую ленту можно сдвинуть за конец
+  pos_ += sizeof(Value);
+  latency_.Move();
+  return true;
+}
+
+template <typename Value>
+bool DirectFileTape<Value>::MoveBackward() {
+  if (pos_ < sizeof(Value)) {
+    return false;
+  }
+  pos_ -= sizeof(Value);
+  latency_.Move();
+  return true;
+}
+
+template <typename Value>
+void DirectFileTape<Value>::MoveToBegin() {
+  latency_.Rewind();
+  pos_ = 0;
+}
+
+template <typename Value>
+void DirectFileTape<Value>::MoveToEnd() {
+  latency_.Rewind();
+  pos_ = size_;
+}
+
+template <typename Value>
+std::chrono::microseconds DirectFileTape<Value>::GetElapsedTime() const {
+  return latency_.Elapsed();
+}
+
+template <typename Value>
+core::IoQueue::Kind DirectFileTape<Value>::GetIoKind() const {
+  return io_queue_->GetKind();
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::GetQueueDepth(const Configuration &config) {
+  return std::max<size_t>(2, config.GetProperty(kQueueDepthKey, kQueueDepthDefault));
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::ReadInto_(std::span<Value> values) {
+  const auto left = pos_ < size_ ? (size_ - pos_) / sizeof(Value) : 0;
+  const auto count = std::min(values.size(), left);
+  auto *dest = reinterpret_cast<std::byte *>(values.data());
+  auto bytes = count * sizeof(Value);
+  while (bytes > 0) {
+    const auto chunk = pos_ / chunk_size_;
+    const auto offset = pos_ % chunk_size_;
+    const auto part = std::min(bytes, chunk_size_ - offset);
+    const auto &slot = AcquireForRead(chunk);
+    std::memcpy(dest, slot.buffer.get() + offset, part);
+    dest += part;
+    pos_ += part;
+    bytes -= part;
+  }
+  return count;
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::WriteFrom_(std::span<const Value> values) {
+  const auto *src = reinterpret_cast<const std::byte *>(values.data());
+  auto bytes = values.size_bytes();
+  while (bytes > 0) {
+    const auto chunk = pos_ / chunk_size_;
+    const auto offset = pos_ % chunk_size_;
+    const auto part = std::min(bytes, chunk_size_ - offset);
+    auto &slot = AcquireForWrite(chunk);
+    std::memcpy(slot.buffer.get() + offset, src, part);
+    slot.dirty = true;
+    src += part;
+    pos_ += part;
+    bytes -= part;
+    size_ = std::max(size_, pos_);
+    if (offset + part == chunk_size_) {
+      // чанк заполнен до конца: при последовательной записи он больше не изменится
+      SubmitWrite(slot);
+    }
+  }
+  return values.size();
+}
+
+template <typename Value>
+auto DirectFileTape<Value>::AcquireForRead(const size_t chunk) -> Slot & {
+  auto *slot = Find(chunk);
+  if (slot == nullptr) {
+    slot = &Evict(chunk, chunk + 1);
+    SubmitRead(*slot, chunk);
+  }
+  const auto chunk_count = (size_ + chunk_size_ - 1) / chunk_size_;
+  const auto last = std::min(chunk + slots_.size(), chunk_count);
+  for (auto next = chunk + 1; next < last; ++next) {
+    if (Find(next) == nullptr) {
+      SubmitRead(Evict(chunk, last), next);
+    }
+  }
+  if (slot->reading) {
+    Complete(*slot);
+  }
+  return *slot;
+}
+
+template <typename Value>
+auto DirectFileTape<Value>::AcquireForWrite(const size_t chunk) -> Slot & {
+  auto *slot = Find(chunk);
+  if (slot == nullptr) {
+    slot = &Evict(chunk, chunk + 1);
+    if (chunk * chunk_size_ < size_) {
+      SubmitRead(*slot, chunk);
+    } else {
+      slot->chunk = chunk;
+      std::memset(slot->buffer.get(), 0, chunk_size_);
+    }
+  }
+  // буфер нельзя менять, пока выполняется операция над ним
+  Complete(*slot);
+  return *slot;
+}
+
+template <typename Value>
+auto DirectFileTape<Value>::Find(const size_t chunk) -> Slot * {
+  const auto slot = std::ranges::find(slots_, std::optional(chunk), &Slot::chunk);
+  return slot == slots_.end() ? nullptr : &*slot;
+}
+
+template <typename Value>
+auto DirectFileTape<Value>::Evict(const size_t first, const size_t last) -> Slot & {
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    auto &slot = slots_[(next_victim_ + i) % slots_.size()];
+    if (slot.chunk && *slot.chunk >= first && *slot.chunk < last) {
+      continue;
+    }
+    next_victim_ = (SlotIndex(slot) + 1) % slots_.size();
+    Complete(slot);
+    if (slot.dirty) {
+      SubmitWrite(slot);
+      Complete(slot);
+    }
+    slot.chunk.reset();
+    return slot;
+  }
+  throw std::logic_error("There is no free direct I/O buffer.");
+}
+
+template <typename Value>
+void DirectFileTape<Value>::SubmitRead(Slot &slot, const size_t chunk) {
+  slot.chunk = chunk;
+  slot.in_flight = true;
+  slot.reading = true;
+  io_queue_->SubmitRead(
+      fd_, slot.buffer.get(), chunk_size_, static_cast<off_t>(chunk * chunk_size_), SlotIndex(slot)
+  );
+}
+
+template <typename Value>
+void DirectFileTape<Value>::SubmitWrite(Slot &slot) {
+  slot.in_flight = true;
+  slot.dirty = false;
+  io_queue_->SubmitWrite(
+      fd_,
+      slot.buffer.get(),
+      chunk_size_,
+      static_cast<off_t>(*slot.chunk * chunk_size_),
+      SlotIndex(slot)
+  );
+}
+
+template <typename Value>
+void DirectFileTape<Value>::Complete(Slot &slot) {
+  if (!slot.in_flight) {
+    return;
+  }
+  const auto reading = slot.reading;
+  const auto fail = [this, &slot, reading](const std::string &reason) {
+    slot.in_flight = false;
+    slot.reading = false;
+    slot.chunk.reset();
+    return std::runtime_error(
+        std::string("Couldn't ") + (reading ? "read" : "write") + " the tape chunk: " + reason
+    );
+  };
+  const auto chunk_offset = *slot.chunk * chunk_size_;
+  // начало последней отправленной операции в чанке
+  size_t start = 0;
+  size_t done = 0;
+  while (true) {
+    const auto result = io_queue_->Wait(SlotIndex(slot));
+    if (result < 0) {
+      throw fail(std::strerror(static_cast<int>(-result)));
+    }
+    done = start + static_cast<size_t>(result);
+    if (done == chunk_size_) {
+      break;
+    }
+    if (reading && (result == 0 || chunk_offset + done >= GetFileSize())) {
+      // за концом файла данных нет
+      std::memset(slot.buffer.get() + done, 0, chunk_size_ - done);
+      break;
+    }
+    if (result == 0) {
+      throw fail("the device accepted no data.");
+    }
+    // операция выполнена не полностью посреди файла: остаток запрашивается повторно. С O_DIRECT
+    // смещение и размер операции должны быть выровнены, поэтому невыровненный хвост переданной
+    // части передается заново
+    const auto restart = done - done % kAlignment;
+    if (restart == start) {
+      throw fail("the device transferred less than an aligned block.");
+    }
+    start = restart;
+    const auto offset = static_cast<off_t>(chunk_offset + start);
+    if (reading) {
+      io_queue_->SubmitRead(
+          fd_, slot.buffer.get() + start, chunk_size_ - start, offset, SlotIndex(slot)
+      );
+    } else {
+      io_queue_->SubmitWrite(
+          fd_, slot.buffer.get() + start, chunk_size_ - start, offset, SlotIndex(slot)
+      );
+    }
+  }
+  slot.in_flight = false;
+  slot.reading = false;
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::GetFileSize() const {
+  struct stat file_stat {};
+  if (fstat(fd_, &file_stat) != 0) {
+    throw std::runtime_error("Couldn't get the size of the tape file.");
+  }
+  return static_cast<size_t>(file_stat.st_size);
+}
+
+template <typename Value>
+size_t DirectFileTape<Value>::SlotIndex(const Slot &slot) const {
+  return static_cast<size_t>(&slot - slots_.data());
+}
+
+}  // namespace sot
+
+#endif  // DIRECT_FILE_TAPE_H
@@ -1,20 +1,33 @@
 #ifndef FILE_TAPE_IMPL_H
 #define FILE_TAPE_IMPL_H
 
-#include <chrono>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
-#include <thread>
 
 #include "configuration.h"
+#include "memory_literals.h"
 #include "tape.h"
+#include "tape_latency.h"
 
 namespace sot {
 
+using namespace memory_literals;
+
 /**
  * \brief Эмулятор устройства типа ленты на основе файла.
  *
+ * Блочные операции выполняются одним чтением или записью n * sizeof(Value) байт через буфер
+ * потока настраиваемого размера. Задержки устройства задаются как в @link TapeLatency @endlink.
+ *
+ * Подсказка последовательного доступа posix_fadvise не передается: она действует только на
+ * открытое описание файла, дескриптор которого файловый поток не предоставляет, а отдельно
+ * открытый дескриптор на чтение потока не влияет. Последовательный доступ обеспечивает буфер
+ * потока: каждый блок читается одним системным вызовом, а упреждающее чтение ядра срабатывает на
+ * последовательных чтениях и без подсказки.
+ *
  * \tparam Value тип данных для хранения на устройстве.
  * \tparam Mutable можно ли изменять данные в файле.
  */
@@ -29,61 +42,49 @@ class FileTape : public Tape<Value> {
   using ValuesIterator = typename Tape<Value>::ValuesIterator;
   /// Константный итератор вектора из элементов.
   using ValuesConstIterator = typename Tape<Value>::ValuesConstIterator;
-  /// Единицы измерения "задержек" устройства.
-  using Duration = std::chrono::microseconds;
-
-  /// Ключ в конфигурации,
-  /// задающий задержку чтения с устройства в @link Duration заданных единицах@endlink.
-  static constexpr auto kReadDurationKey = "read_duration";
-  /// Ключ в конфигурации,
-  /// задающий задержку записи на устройства в @link Duration заданных единицах@endlink.
-  static constexpr auto kWriteDurationKey = "write_duration";
-  /// Ключ в конфигурации,
-  /// задающий задержку перемотки ленты в @link Duration заданных единицах@endlink.
-  static constexpr auto kMoveDurationKey = "move_duration";
-  /// Ключ в конфигурации,
-  /// задающий задержку сдвига ленты на одну позицию в @link Duration заданных единицах@endlink.
-  static constexpr auto kRewindDurationKey = "rewind_duration";
-  /// Ключ в конфигурации,
-  /// задающий задержку преодоления межблочного промежутка ленты в @link Duration заданных
-  /// единицах@endlink.
-  static constexpr auto kGapCrossDurationKey = "gap_cross_duration";
-
-  /// Значение задержки чтения по умолчанию в @link Duration заданных единицах@endlink.
-  static constexpr auto kReadDurationDefault = 7;
-  /// Значение задержки записи по умолчанию в @link Duration заданных единицах@endlink.
-  static constexpr auto kWriteDurationDefault = 7;
-  /// Значение задержки перемотки по умолчанию в @link Duration заданных единицах@endlink.
-  static constexpr auto kMoveDurationDefault = 1;
-  /// Значение задержки сдвига по умолчанию в @link Duration заданных единицах@endlink.
-  static constexpr auto kRewindDurationDefault = 1000;
-  /// Значение задержки преодоления межблочного промежутка по умолчанию в @link Duration заданных
-  /// единицах@endlink.
-  static constexpr auto kGapCrossDurationDefault = 200;
+
+  /// Ключ в конфигурации, задающий размер буфера файлового потока в байтах (0 - размер по
+  /// умолчанию стандартной библиотеки).
+  static constexpr auto kBufferSizeKey = "file_buffer_size";
+
+  /// Значение размера буфера файлового потока по умолчанию в байтах.
+  static constexpr size_t kBufferSizeDefault = 64_KiB;
 
   FileTape(const Configuration &config, const std::string &file_name);
+  /**
+   * \param buffered использовать ли буфер потока, иначе каждая операция обращается к файлу
+   * напрямую и лента не занимает памяти под буфер.
+   */
+  FileTape(const Configuration &config, const std::string &file_name, bool buffered);
   FileTape(FileTape &&other) = default;
   FileTape(const FileTape &other) = delete;
   FileTape &operator=(const FileTape &other) = delete;
   FileTape &operator=(FileTape &&other) = default;
 
+  /**
+   * \brief Получить объем памяти в байтах, который занимает буфер потока ленты с заданной
+   * конфигурацией.
+   */
+  [[nodiscard]] static size_t GetBufferSize(const Configuration &config);
+
   std::optional<Value> Read() override;
   Values ReadN(size_t n) override;
+  size_t ReadInto(std::span<Value> values) override;
   bool Write(const Value &value) override;
   size_t WriteN(const Values &values) override;
   ValuesConstIterator WriteN(ValuesConstIterator begin, ValuesConstIterator end) override;
+  size_t WriteFrom(std::span<const Value> values) override;
   bool MoveForward() override;
   bool MoveBackward() override;
   void MoveToBegin() override;
   void MoveToEnd() override;
+  [[nodiscard]] std::chrono::microseconds GetElapsedTime() const override;
 
  private:
+  /// Буфер потока, должен жить не меньше самого потока.
+  std::unique_ptr<char[]> buffer_;
   mutable std::fstream fstream_;
-  Duration read_duration_;
-  Duration write_duration_;
-  Duration move_duration_;
-  Duration rewind_duration_;
-  Duration gap_cross_duration_;
+  TapeLatency latency_;
 
   /**
    * \brief Получить последнюю позицию в файле.
@@ -97,15 +98,26 @@ class FileTape : public Tape<Value> {
    * \brief Чтение одного элемента, но без дополнительных задержек.
    */
   std::optional<Value> Read_();
+  /**
+   * \brief Чтение значений в буфер, но без дополнительных задержек.
+   */
+  size_t ReadInto_(std::span<Value> values);
+  /**
+   * \brief Запись значений из буфера, но без дополнительных задержек.
+   */
+  size_t WriteFrom_(std::span<const Value> values);
 };
 
 template <typename Value, bool Mutable>
 FileTape<Value, Mutable>::FileTape(const Configuration &config, const std::string &file_name)
-    : read_duration_(config.GetProperty(kReadDurationKey, kReadDurationDefault)),
-      write_duration_(config.GetProperty(kWriteDurationKey, kWriteDurationDefault)),
-      move_duration_(config.GetProperty(kMoveDurationKey, kMoveDurationDefault)),
-      rewind_duration_(config.GetProperty(kRewindDurationKey, kRewindDurationDefault)),
-      gap_cross_duration_(config.GetProperty(kGapCrossDurationKey, kGapCrossDurationDefault)) {
+    : FileTape(config, file_name, true) {
+}
+
+template <typename Value, bool Mutable>
+FileTape<Value, Mutable>::FileTape(
+    const Configuration &config, const std::string &file_name, const bool buffered
+)
+    : latency_(config) {
   auto mode = std::ios_base::in | std::ios_base::binary;
   if (Mutable) {
     mode |= std::ios_base::out;
@@ -115,71 +127,77 @@ FileTape<Value, Mutable>::FileTape(const Configuration &config, const std::strin
       mode |= std::ios_base::trunc;
     }
   }
-  fstream_ = std::fstream(file_name, mode);
+  const auto buffer_size = config.GetProperty(kBufferSizeKey, kBufferSizeDefault);
+  if (!buffered) {
+    fstream_.rdbuf()->pubsetbuf(nullptr, 0);
+  } else if (buffer_size > 0) {
+    buffer_ = std::make_unique<char[]>(buffer_size);
+    fstream_.rdbuf()->pubsetbuf(buffer_.get(), static_cast<std::streamsize>(buffer_size));
+  }
+  fstream_.open(file_name, mode);
   if (!fstream_) {
     throw std::invalid_argument("Couldn't open the file with name '" + file_name + "'.");
   }
 }
 
+template <typename Value, bool Mutable>
+size_t FileTape<Value, Mutable>::GetBufferSize(const Configuration &config) {
+  // без заданного буфера файловый поток выделяет собственный размером BUFSIZ
+  const auto buffer_size = config.GetProperty(kBufferSizeKey, kBufferSizeDefault);
+  return buffer_size > 0 ? buffer_size : BUFSIZ;
+}
+
 template <typename Value, bool Mutable>
 std::optional<Value> FileTape<Value, Mutable>::Read() {
-  std::this_thread::sleep_for(read_duration_ + move_duration_ + gap_cross_duration_);
+  latency_.Read(1);
   return Read_();
 }
 
 template <typename Value, bool Mutable>
 auto FileTape<Value, Mutable>::ReadN(const size_t n) -> Values {
-  std::vector<Value> values;
-  for (size_t i = 0; i < n; ++i) {
-    const auto value = Read_();
-    if (!value) {
-      break;
-    }
-    values.push_back(*value);
-  }
-  std::this_thread::sleep_for(
-      values.size() * (read_duration_ + move_duration_) + gap_cross_duration_
-  );
+  // буфер выделяется один раз с учетом количества оставшихся в файле значений
+  const auto left = static_cast<size_t>(GetLastPos() - fstream_.tellg()) / sizeof(Value);
+  Values values(std::min(n, left));
+  values.resize(ReadInto_(values));
+  latency_.Read(values.size());
   return values;
 }
 
+template <typename Value, bool Mutable>
+size_t FileTape<Value, Mutable>::ReadInto(std::span<Value> values) {
+  const auto read = ReadInto_(values);
+  latency_.Read(read);
+  return read;
+}
+
 template <typename Value, bool Mutable>
 bool FileTape<Value, Mutable>::Write(const Value &value) {
-  std::this_thread::sleep_for(write_duration_ + move_duration_ + gap_cross_duration_);
+  latency_.Write(1);
   return Write_(value);
 }
 
 template <typename Value, bool Mutable>
 size_t FileTape<Value, Mutable>::WriteN(const Values &values) {
-  size_t i;
-  for (i = 0; i < values.size(); ++i) {
-    if (!Write_(values[i])) {
-      break;
-    }
-  }
-  std::this_thread::sleep_for(i * (write_duration_ + move_duration_) + gap_cross_duration_);
-  return i;
+  return WriteFrom(values);
 }
 
 template <typename Value, bool Mutable>
 auto FileTape<Value, Mutable>::WriteN(ValuesConstIterator begin, ValuesConstIterator end)
     -> ValuesConstIterator {
-  size_t written = 0;
-  while (begin < end) {
-    if (!Write_(*begin)) {
-      break;
-    }
-    ++begin;
-    ++written;
-  }
-  std::this_thread::sleep_for(written * (write_duration_ + move_duration_) + gap_cross_duration_);
-  return begin;
+  return begin + static_cast<std::ptrdiff_t>(WriteFrom({begin, end}));
+}
+
+template <typename Value, bool Mutable>
+size_t FileTape<Value, Mutable>::WriteFrom(std::span<const Value> values) {
+  const auto written = WriteFrom_(values);
+  latency_.Write(written);
+  return written;
 }
 
 template <typename Value, bool Mutable>
 bool FileTape<Value, Mutable>::MoveForward() {
   const auto before = fstream_.tellg();
-  const auto next_pos = fstream_.tellg() + sizeof(Value);
+  const auto next_pos = before + static_cast<std::streamoff>(sizeof(Value));
   if (!Mutable) {
     const auto last_pos = GetLastPos();
     if (next_pos > last_pos) {
@@ -192,7 +210,7 @@ bool FileTape<Value, Mutable>::MoveForward() {
     fstream_.seekg(before);
     return false;
   }
-  std::this_thread::sleep_for(move_duration_);
+  latency_.Move();
   return true;
 }
 
@@ -205,22 +223,27 @@ bool FileTape<Value, Mutable>::MoveBackward() {
     fstream_.seekg(before);
     return false;
   }
-  std::this_thread::sleep_for(move_duration_);
+  latency_.Move();
   return true;
 }
 
 template <typename Value, bool Mutable>
 void FileTape<Value, Mutable>::MoveToBegin() {
-  std::this_thread::sleep_for(rewind_duration_);
+  latency_.Rewind();
   fstream_.seekg(0);
 }
 
 template <typename Value, bool Mutable>
 void FileTape<Value, Mutable>::MoveToEnd() {
-  std::this_thread::sleep_for(rewind_duration_);
+  latency_.Rewind();
   fstream_.seekg(0, std::ios_base::end);
 }
 
+template <typename Value, bool Mutable>
+std::chrono::microseconds FileTape<Value, Mutable>::GetElapsedTime() const {
+  return latency_.Elapsed();
+}
+
 template <typename Value, bool Mutable>
 std::fstream::pos_type FileTape<Value, Mutable>::GetLastPos() const {
   const auto prev_pos = fstream_.tellg();
@@ -232,27 +255,48 @@ std::fstream::pos_type FileTape<Value, Mutable>::GetLastPos() const {
 
 template <typename Value, bool Mutable>
 bool FileTape<Value, Mutable>::Write_(const Value &value) {
-  const auto before = fstream_.tellg();
-  fstream_.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  return WriteFrom_({&value, 1}) == 1;
+}
+
+template <typename Value, bool Mutable>
+std::optional<Value> FileTape<Value, Mutable>::Read_() {
+  Value value;
+  if (ReadInto_({&value, 1}) == 0) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+template <typename Value, bool Mutable>
+size_t FileTape<Value, Mutable>::ReadInto_(std::span<Value> values) {
+  fstream_.read(
+      reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(values.size_bytes())
+  );
+  const auto read_bytes = static_cast<size_t>(fstream_.gcount());
   if (!fstream_) {
+    // конец файла: указатель должен остаться за последним целиком прочитанным значением
     fstream_.clear();
-    fstream_.seekg(before);
-    return false;
+    fstream_.seekg(-static_cast<std::streamoff>(read_bytes % sizeof(Value)), std::ios_base::cur);
   }
-  return true;
+  return read_bytes / sizeof(Value);
 }
 
 template <typename Value, bool Mutable>
-std::optional<Value> FileTape<Value, Mutable>::Read_() {
-  Value value;
+size_t FileTape<Value, Mutable>::WriteFrom_(std::span<const Value> values) {
+  if (!Mutable) {
+    return 0;
+  }
   const auto before = fstream_.tellg();
-  fstream_.read(reinterpret_cast<char *>(&value), sizeof(value));
+  fstream_.write(
+      reinterpret_cast<const char *>(values.data()),
+      static_cast<std::streamsize>(values.size_bytes())
+  );
   if (!fstream_) {
     fstream_.clear();
     fstream_.seekg(before);
-    return std::nullopt;
+    return 0;
   }
-  return value;
+  return values.size();
 }
 
 }  // namespace sot
@@ -0,0 +1,297 @@
+#ifndef FORECASTING_RUN_READER_H
+#define FORECASTING_RUN_READER_H
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "core/io_executor.h"
+#include "tape.h"
+
+namespace sot {
+
+/**
+ * \brief Блочное чтение сливаемых серий с упреждением по прогнозу (forecasting, Кнут).
+ *
+ * У каждой серии есть один буфер, а несколько запасных буферов общие для всех серий. Следующим
+ * исчерпается буфер той серии, последнее значение которого наименьшее, поэтому в свободный запасной
+ * буфер потоком ввода-вывода читается следующий блок именно этой серии. Когда буфер серии
+ * исчерпывается, он меняется местами с прочитанным заранее и возвращается в запас; если прогноз не
+ * успел, блок читается синхронно. Так задержка чтения скрывается несколькими дополнительными
+ * буферами вместо удвоения буферов всех серий, что существенно при слиянии сотни и более серий.
+ *
+ * \tparam Value тип элементов серий.
+ * \tparam Comparator компаратор, по которому отсортированы серии.
+ */
+template <typename Value, typename Comparator>
+class ForecastingRunReader {
+ public:
+  using TapeSharedPtr = std::shared_ptr<Tape<Value>>;
+
+  /**
+   * \param tapes ленты серий, которые не должны использоваться напрямую, пока существует читатель;
+   * \param block_size размер каждого буфера;
+   * \param spare_count количество запасных буферов, 0 - чтение без упреждения;
+   * \param io_executor потоки упреждающего чтения, обязательны при запасных буферах и должны
+   * существовать дольше читателя;
+   * \param comparator компаратор.
+   */
+  ForecastingRunReader(
+      std::vector<TapeSharedPtr> tapes,
+      size_t block_size,
+      size_t spare_count = 0,
+      core::IoExecutor *io_executor = nullptr,
+      Comparator comparator = Comparator()
+  );
+  /**
+   * \brief Создать читателя, буферы которого размещаются во внешней памяти.
+   *
+   * \param buffer память не меньше (tapes.size() + spare_count) * block_size значений, которая
+   * должна существовать дольше читателя.
+   */
+  ForecastingRunReader(
+      std::vector<TapeSharedPtr> tapes,
+      std::span<Value> buffer,
+      size_t block_size,
+      size_t spare_count = 0,
+      core::IoExecutor *io_executor = nullptr,
+      Comparator comparator = Comparator()
+  );
+  ForecastingRunReader(const ForecastingRunReader &) = delete;
+  ForecastingRunReader &operator=(const ForecastingRunReader &) = delete;
+  ~ForecastingRunReader();
+
+  /**
+   * \brief Получить объем памяти в байтах, который занимает состояние читателя без буферов блоков.
+   */
+  [[nodiscard]] static size_t GetMemoryUsage(size_t run_count, size_t spare_count);
+
+  /**
+   * \brief Сдвинуть курсор серии вперед на одну позицию.
+   * \return false - если серия исчерпана.
+   */
+  bool MoveForward(size_t run);
+  /**
+   * \brief Сдвинуть курсор серии вперед на заданное количество позиций в пределах текущего блока.
+   * \param count количество позиций, не больше размера @link ReadBlock @endlink.
+   * \return false - если серия исчерпана.
+   */
+  bool Skip(size_t run, size_t count);
+  /**
+   * \brief Прочитать значение серии на текущей позиции.
+   */
+  const Value &Read(size_t run) const;
+  /**
+   * \brief Получить значения текущего блока серии, начиная с текущей позиции.
+   */
+  std::span<const Value> ReadBlock(size_t run) const;
+  /**
+   * \brief Проверить, исчерпана ли серия.
+   */
+  [[nodiscard]] bool IsEnd(size_t run) const;
+
+ private:
+  /// Буфер серии.
+  struct Buffer {
+    std::span<Value> values;
+    /// Количество прочитанных в буфер значений.
+    size_t size = 0;
+  };
+  /// Состояние серии.
+  struct Run {
+    TapeSharedPtr tape;
+    Buffer current;
+    size_t pos = 0;
+    /// Прочитан неполный блок, то есть достигнут конец ленты.
+    bool tape_end = false;
+    /// Буфер, в который в фоне читается следующий блок, пуст, если чтение не выполняется.
+    std::span<Value> next;
+    std::future<size_t> next_size;
+  };
+
+  /// Собственная память буферов, пуста, если они размещаются во внешней памяти.
+  std::vector<Value> storage_;
+  std::vector<Run> runs_;
+  /// Свободные запасные буферы.
+  std::vector<std::span<Value>> spares_;
+  core::IoExecutor *io_executor_;
+  const size_t block_size_;
+  Comparator comparator_;
+
+  /**
+   * \brief Заполнить исчерпанный буфер серии следующим блоком.
+   */
+  void ReadNextBlock(Run &run);
+  /**
+   * \brief Начать чтение в свободные запасные буферы для серий, которые исчерпаются раньше других.
+   */
+  void Forecast();
+};
+
+template <typename Value, typename Comparator>
+ForecastingRunReader<Value, Comparator>::ForecastingRunReader(
+    std::vector<TapeSharedPtr> tapes,
+    const size_t block_size,
+    const size_t spare_count,
+    core::IoExecutor *io_executor,
+    Comparator comparator
+)
+    : ForecastingRunReader(
+          std::move(tapes), {}, block_size, spare_count, io_executor, std::move(comparator)
+      ) {
+}
+
+template <typename Value, typename Comparator>
+ForecastingRunReader<Value, Comparator>::ForecastingRunReader(
+    std::vector<TapeSharedPtr> tapes,
+    std::span<Value> buffer,
+    const size_t block_size,
+    const size_t spare_count,
+    core::IoExecutor *io_executor,
+    Comparator comparator
+)
+    : runs_(tapes.size()),
+      io_executor_(io_executor),
+      block_size_(block_size),
+      comparator_(std::move(comparator)) {
+  if (block_size == 0) {
+    throw std::runtime_error("Block size must be positive.");
+  }
+  if (spare_count != 0 && !io_executor) {
+    throw std::invalid_argument("Forecasting requires an I/O executor.");
+  }
+  const auto buffer_count = tapes.size() + spare_count;
+  if (buffer.data() == nullptr) {
+    storage_.resize(buffer_count * block_size);
+    buffer = storage_;
+  } else if (buffer.size() < buffer_count * block_size) {
+    throw std::invalid_argument("The buffer is too small for the blocks of all runs.");
+  }
+  for (size_t i = 0; i < buffer_count; ++i) {
+    const auto block = buffer.subspan(i * block_size, block_size);
+    if (i < runs_.size()) {
+      runs_[i].current.values = block;
+    } else {
+      spares_.push_back(block);
+    }
+  }
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    auto &run = runs_[i];
+    run.tape = std::move(tapes[i]);
+    ReadNextBlock(run);
+  }
+  Forecast();
+}
+
+template <typename Value, typename Comparator>
+ForecastingRunReader<Value, Comparator>::~ForecastingRunReader() {
+  // фоновые чтения пишут в буферы серий, поэтому дожидаются до их освобождения
+  for (auto &run : runs_) {
+    if (run.next_size.valid()) {
+      run.next_size.wait();
+    }
+  }
+}
+
+template <typename Value, typename Comparator>
+size_t ForecastingRunReader<Value, Comparator>::GetMemoryUsage(
+    const size_t run_count, const size_t spare_count
+) {
+  return run_count * sizeof(Run) + spare_count * sizeof(std::span<Value>);
+}
+
+template <typename Value, typename Comparator>
+bool ForecastingRunReader<Value, Comparator>::MoveForward(const size_t run_index) {
+  auto &run = runs_[run_index];
+  if (++run.pos < run.current.size) {
+    return true;
+  }
+  ReadNextBlock(run);
+  Forecast();
+  return run.current.size != 0;
+}
+
+template <typename Value, typename Comparator>
+bool ForecastingRunReader<Value, Comparator>::Skip(const size_t run_index, const size_t count) {
+  auto &run = runs_[run_index];
+  if (count > run.current.size - std::min(run.pos, run.current.size)) {
+    throw std::runtime_error("Tried to skip out of the block.");
+  }
+  run.pos += count;
+  if (run.pos < run.current.size) {
+    return true;
+  }
+  ReadNextBlock(run);
+  Forecast();
+  return run.current.size != 0;
+}
+
+template <typename Value, typename Comparator>
+const Value &ForecastingRunReader<Value, Comparator>::Read(const size_t run_index) const {
+  const auto &run = runs_[run_index];
+  if (run.pos >= run.current.size) {
+    throw std::runtime_error("Tried to read out of bounds.");
+  }
+  return run.current.values[run.pos];
+}
+
+template <typename Value, typename Comparator>
+std::span<const Value> ForecastingRunReader<Value, Comparator>::ReadBlock(
+    const size_t run_index
+) const {
+  const auto &run = runs_[run_index];
+  return std::span<const Value>(run.current.values).first(run.current.size).subspan(run.pos);
+}
+
+template <typename Value, typename Comparator>
+bool ForecastingRunReader<Value, Comparator>::IsEnd(const size_t run_index) const {
+  const auto &run = runs_[run_index];
+  return run.pos >= run.current.size;
+}
+
+template <typename Value, typename Comparator>
+void ForecastingRunReader<Value, Comparator>::ReadNextBlock(Run &run) {
+  run.pos = 0;
+  if (run.next_size.valid()) {
+    run.current.size = run.next_size.get();
+    std::swap(run.current.values, run.next);
+    spares_.push_back(run.next);
+    run.next = {};
+  } else if (run.tape_end) {
+    run.current.size = 0;
+  } else {
+    run.current.size = run.tape->ReadInto(run.current.values);
+  }
+  run.tape_end = run.tape_end || run.current.size < block_size_;
+}
+
+template <typename Value, typename Comparator>
+void ForecastingRunReader<Value, Comparator>::Forecast() {
+  while (!spares_.empty()) {
+    Run *next = nullptr;
+    for (auto &run : runs_) {
+      if (run.tape_end || run.next_size.valid()) {
+        continue;
+      }
+      const auto &last = run.current.values[run.current.size - 1];
+      if (!next || comparator_(last, next->current.values[next->current.size - 1])) {
+        next = &run;
+      }
+    }
+    if (!next) {
+      return;
+    }
+    next->next = spares_.back();
+    spares_.pop_back();
+    next->next_size = io_executor_->Submit([tape = next->tape, buffer = next->next]() {
+      return tape->ReadInto(buffer);
+    });
+  }
+}
+
+}  // namespace sot
+
+#endif  // FORECASTING_RUN_READER_H
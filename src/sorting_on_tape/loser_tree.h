@@ -0,0 +1,201 @@
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace sot {
+
+/**
+ * \brief Дерево проигравших (турнирное дерево) для k-путевого слияния.
+ *
+ * Хранит только индексы источников и закэшированные текущие значения их голов, поэтому сами
+ * источники никуда не перемещаются. Выбор следующего элемента требует ceil(log2(k)) сравнений.
+ *
+ * \tparam Value тип сливаемых значений.
+ * \tparam Comparator компаратор, по умолчанию используется std::less<Value>.
+ */
+template <typename Value, typename Comparator = std::less<Value>>
+class LoserTree {
+ public:
+  explicit LoserTree(size_t source_count, Comparator comparator = Comparator());
+
+  /**
+   * \brief Получить объем памяти в байтах, который занимает дерево заданного количества
+   * источников вместе с временными данными построения.
+   */
+  [[nodiscard]] static size_t GetMemoryUsage(size_t source_count);
+
+  /**
+   * \brief Задать начальное значение источника.
+   *
+   * Источники, для которых значение не задано до вызова @link Build @endlink, считаются пустыми.
+   */
+  void Push(size_t source, Value value);
+  /**
+   * \brief Построить дерево по заданным начальным значениям.
+   */
+  void Build();
+  /**
+   * \brief Проверить, исчерпаны ли все источники.
+   */
+  [[nodiscard]] bool Empty() const;
+  /**
+   * \brief Получить индекс источника с наименьшим значением.
+   */
+  [[nodiscard]] size_t Top() const;
+  /**
+   * \brief Получить наименьшее значение среди голов источников.
+   */
+  [[nodiscard]] const Value &TopValue() const;
+  /**
+   * \brief Получить наименьшее значение среди голов источников, кроме победителя.
+   *
+   * Это лучший из проигравших на пути от победителя к корню, поэтому требуется ceil(log2(k))
+   * сравнений.
+   *
+   * \return nullptr - если остальные источники исчерпаны.
+   */
+  [[nodiscard]] const Value *SecondValue() const;
+  /**
+   * \brief Заменить значение источника-победителя следующим значением из этого же источника.
+   */
+  void ReplaceTop(Value value);
+  /**
+   * \brief Пометить источник-победитель как исчерпанный.
+   */
+  void PopTop();
+
+ private:
+  /// Голова источника.
+  struct Leaf {
+    Value value{};
+    bool exhausted = true;
+  };
+
+  Comparator comparator_;
+  std::vector<Leaf> leaves_;
+  /// Проигравшие во внутренних узлах, узел i имеет потомков 2i и 2i + 1, листья - [k, 2k).
+  std::vector<size_t> losers_;
+  size_t winner_ = 0;
+
+  /**
+   * \brief Проверить, что голова источника first строго меньше головы источника second.
+   *
+   * Исчерпанные источники считаются больше любых значений.
+   */
+  [[nodiscard]] bool Less(size_t first, size_t second) const;
+  /**
+   * \brief Переиграть матчи на пути от листа победителя к корню.
+   */
+  void Replay();
+};
+
+template <typename Value, typename Comparator>
+LoserTree<Value, Comparator>::LoserTree(const size_t source_count, Comparator comparator)
+    : comparator_(std::move(comparator)), leaves_(source_count), losers_(source_count, 0) {
+}
+
+template <typename Value, typename Comparator>
+size_t LoserTree<Value, Comparator>::GetMemoryUsage(const size_t source_count) {
+  // листья и проигравшие, а при построении - победители поддеревьев
+  return source_count * (sizeof(Leaf) + 3 * sizeof(size_t));
+}
+
+template <typename Value, typename Comparator>
+void LoserTree<Value, Comparator>::Push(const size_t source, Value value) {
+  if (source >= leaves_.size()) {
+    throw std::out_of_range("Source index is out of range.");
+  }
+  leaves_[source] = {std::move(value), false};
+}
+
+template <typename Value, typename Comparator>
+void LoserTree<Value, Comparator>::Build() {
+  const auto k = leaves_.size();
+  if (k == 0) {
+    return;
+  }
+  // победители поддеревьев нужны только на время построения
+  std::vector<size_t> winners(2 * k);
+  for (size_t i = 0; i < k; ++i) {
+    winners[k + i] = i;
+  }
+  for (size_t node = k - 1; node > 0; --node) {
+    const auto left = winners[2 * node];
+    const auto right = winners[2 * node + 1];
+    if (Less(right, left)) {
+      winners[node] = right;
+      losers_[node] = left;
+    } else {
+      winners[node] = left;
+      losers_[node] = right;
+    }
+  }
+  winner_ = winners[1];
+}
+
+template <typename Value, typename Comparator>
+bool LoserTree<Value, Comparator>::Empty() const {
+  return leaves_.empty() || leaves_[winner_].exhausted;
+}
+
+template <typename Value, typename Comparator>
+size_t LoserTree<Value, Comparator>::Top() const {
+  return winner_;
+}
+
+template <typename Value, typename Comparator>
+const Value &LoserTree<Value, Comparator>::TopValue() const {
+  return leaves_[winner_].value;
+}
+
+template <typename Value, typename Comparator>
+const Value *LoserTree<Value, Comparator>::SecondValue() const {
+  const Leaf *second = nullptr;
+  for (auto node = (winner_ + leaves_.size()) / 2; node > 0; node /= 2) {
+    const auto &loser = leaves_[losers_[node]];
+    if (!loser.exhausted && (!second || comparator_(loser.value, second->value))) {
+      second = &loser;
+    }
+  }
+  return second ? &second->value : nullptr;
+}
+
+template <typename Value, typename Comparator>
+void LoserTree<Value, Comparator>::ReplaceTop(Value value) {
+  leaves_[winner_].value = std::move(value);
+  Replay();
+}
+
+template <typename Value, typename Comparator>
+void LoserTree<Value, Comparator>::PopTop() {
+  leaves_[winner_].exhausted = true;
+  Replay();
+}
+
+template <typename Value, typename Comparator>
+bool LoserTree<Value, Comparator>::Less(const size_t first, const size_t second) const {
+  const auto &f = leaves_[first];
+  const auto &s = leaves_[second];
+  if (f.exhausted || s.exhausted) {
+    return !f.exhausted;
+  }
+  return comparator_(f.value, s.value);
+}
+
+template <typename Value, typename Comparator>
+void LoserTree<Value, Comparator>::Replay() {
+  auto winner = winner_;
+  for (auto node = (winner + leaves_.size()) / 2; node > 0; node /= 2) {
+    if (Less(losers_[node], winner)) {
+      std::swap(losers_[node], winner);
+    }
+  }
+  winner_ = winner;
+}
+
+}  // namespace sot
+
+#endif  // LOSER_TREE_H
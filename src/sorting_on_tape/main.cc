@@ -1,61 +1,148 @@
 #include <tape_sorter.h>
 #include <temp_file_tape_provider.h>
 
+#include <concepts>
+#include <filesystem>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 #include "file_tape.h"
+#include "memory_temp_tape_provider.h"
+#include "mmap_file_tape.h"
 #include "tape.h"
 
 using namespace sot;
 
 using TapeValue = std::int32_t;
-using Comparator = std::function<bool(const TapeValue &, const TapeValue &)>;
 using Tape = Tape<TapeValue>;
 using MutableFileTape = FileTape<TapeValue, true>;
 using ImmutableFileTape = FileTape<TapeValue, false>;
+using MutableMmapFileTape = MmapFileTape<TapeValue, true>;
+using ImmutableMmapFileTape = MmapFileTape<TapeValue, false>;
 
-Comparator ParseSortingOrder(const std::string &order_str) {
+/// Флаг, включающий использование отображенных в память файлов для входной и выходной лент.
+constexpr std::string_view kMmapFlag = "--mmap";
+
+/**
+ * \brief Определить порядок сортировки.
+ * \return true, если сортировка выполняется по убыванию.
+ */
+bool ParseSortingOrder(const std::string &order_str) {
   if (order_str == "asc") {
-    return std::less();
+    return false;
   }
   if (order_str == "desc") {
-    return std::greater();
+    return true;
   }
   throw std::invalid_argument(
       "Invalid sorting order! Use 'asc' for ascending order or 'desc' for descending order."
   );
 }
 
+double ToSeconds(const std::chrono::microseconds duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
 template <typename Comparator>
 std::string SortingOrderToString() {
-  if (typeid(Comparator) == typeid(std::less<TapeValue>)) {
+  if constexpr (std::same_as<Comparator, std::less<>>) {
     return "ascending";
   } else {
     return "descending";
   }
 }
 
+/**
+ * \brief Отсортировать данные с входной ленты на выходную в заданном компаратором порядке.
+ *
+ * Компаратор передается типом, а не std::function, чтобы блоки сортировались поразрядно или
+ * векторно.
+ */
+template <typename Comparator>
+SortStatistics SortFile(
+    const Configuration &config,
+    std::shared_ptr<TempTapeProvider<TapeValue>> temp_tape_provider,
+    const std::string &input_file_name,
+    const std::string &output_file_name,
+    sot::Tape<TapeValue> &input_tape,
+    sot::Tape<TapeValue> &output_tape
+) {
+  std::cout << "Start sorting data from '" << input_file_name << "' to '" << output_file_name
+            << "' in " << SortingOrderToString<Comparator>() << " order." << std::endl;
+  const auto value_count = std::filesystem::file_size(input_file_name) / sizeof(TapeValue);
+  return TapeSorter<TapeValue, Comparator>(config, std::move(temp_tape_provider))
+      .Sort(input_tape, output_tape, value_count);
+}
+
 int main(int argc, char *argv[]) {
-  if (argc < 3) {
+  std::vector<std::string> args;
+  bool use_mmap = false;
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i] == kMmapFlag) {
+      use_mmap = true;
+    } else {
+      args.emplace_back(argv[i]);
+    }
+  }
+  if (args.size() < 2) {
     std::cout << "Error: expected input file to sort and output file to print result.\n"
               << "Example: ./sorting-on-tape-runnable input output" << std::endl;
     return 1;
   }
   try {
     const Configuration config;
-    const auto temp_tape_provider = std::make_shared<TempFileTapeProvider<TapeValue>>(config);
-    const auto input_file_name = argv[1];
-    const auto output_file_name = argv[2];
-    const auto comparator = argc >= 4 ? ParseSortingOrder(argv[3]) : std::less();
+    const auto &input_file_name = args[0];
+    const auto &output_file_name = args[1];
+    std::shared_ptr<TempTapeProvider<TapeValue>> temp_tape_provider;
+    if (MemoryTempTapeProvider<TapeValue>::FitsIntoBudget(
+            config, std::filesystem::file_size(input_file_name)
+        )) {
+      temp_tape_provider = std::make_shared<MemoryTempTapeProvider<TapeValue>>(config);
+    } else {
+      temp_tape_provider = std::make_shared<TempFileTapeProvider<TapeValue>>(config);
+    }
+    const auto descending = args.size() >= 3 && ParseSortingOrder(args[2]);
 
-    ImmutableFileTape input_file_tape(config, input_file_name);
-    MutableFileTape output_file_tape(config, output_file_name);
+    std::unique_ptr<sot::Tape<TapeValue>> input_file_tape;
+    std::unique_ptr<sot::Tape<TapeValue>> output_file_tape;
+    if (use_mmap) {
+      input_file_tape = std::make_unique<ImmutableMmapFileTape>(config, input_file_name);
+      output_file_tape = std::make_unique<MutableMmapFileTape>(config, output_file_name);
+    } else {
+      input_file_tape = std::make_unique<ImmutableFileTape>(config, input_file_name);
+      output_file_tape = std::make_unique<MutableFileTape>(config, output_file_name);
+    }
 
-    std::cout << "Start sorting data from '" << input_file_name << "' to '" << output_file_name
-              << "' in " << SortingOrderToString<Comparator>() << " order." << std::endl;
-    TapeSorter<TapeValue, decltype(comparator)>(config, temp_tape_provider, comparator)
-        .Sort(input_file_tape, output_file_tape);
+    const auto statistics =
+        descending ? SortFile<std::greater<>>(
+                         config,
+                         temp_tape_provider,
+                         input_file_name,
+                         output_file_name,
+                         *input_file_tape,
+                         *output_file_tape
+                     )
+                   : SortFile<std::less<>>(
+                         config,
+                         temp_tape_provider,
+                         input_file_name,
+                         output_file_name,
+                         *input_file_tape,
+                         *output_file_tape
+                     );
     std::cout << "The data has been successfully sorted!" << std::endl;
+    if (statistics.plan) {
+      std::cout << "Auto-tuned plan: " << statistics.plan->values_per_thread
+                << " values per thread, " << statistics.plan->thread_count << " threads, "
+                << statistics.plan->merging_group_size
+                << " runs per merge; predicted critical path: "
+                << ToSeconds(statistics.plan->predicted_time) << " s." << std::endl;
+    }
+    std::cout << "Simulated device time: " << ToSeconds(statistics.device_time)
+              << " s, critical path: " << ToSeconds(statistics.critical_path) << " s." << std::endl;
   } catch (std::exception &e) {
     std::cout << "Error: " << e.what() << std::endl;
   } catch (...) {
@@ -0,0 +1,195 @@
+#ifndef MEMORY_TAPE_H
+#define MEMORY_TAPE_H
+
+#include <algorithm>
+#include <optional>
+#include <span>
+
+#include "configuration.h"
+#include "tape.h"
+#include "tape_latency.h"
+
+namespace sot {
+
+/**
+ * \brief Эмулятор изменяемого устройства типа ленты в оперативной памяти.
+ *
+ * Данные хранятся в непрерывном буфере, а указатель ведет себя так же, как у изменяемой
+ * @link FileTape @endlink: его можно сдвинуть за конец ленты, тогда при записи промежуток
+ * заполняется значениями по умолчанию. Если лента создана с конфигурацией, задержки устройства
+ * эмулируются как в @link TapeLatency @endlink, иначе операции выполняются без задержек.
+ *
+ * \tparam Value тип данных для хранения на устройстве.
+ */
+template <typename Value = int32_t>
+class MemoryTape : public Tape<Value> {
+ public:
+  /// Тип данных для хранения на устройстве.
+  using ValueT = typename Tape<Value>::ValueT;
+  /// Вектор, состоящий из элементов.
+  using Values = typename Tape<Value>::Values;
+  /// Итератор вектора из элементов.
+  using ValuesIterator = typename Tape<Value>::ValuesIterator;
+  /// Константный итератор вектора из элементов.
+  using ValuesConstIterator = typename Tape<Value>::ValuesConstIterator;
+
+  /**
+   * \brief Создать ленту без эмуляции задержек.
+   */
+  explicit MemoryTape(Values values = {});
+  /**
+   * \brief Создать ленту с эмуляцией задержек, заданных в конфигурации.
+   */
+  explicit MemoryTape(const Configuration &config, Values values = {});
+
+  std::optional<Value> Read() override;
+  Values ReadN(size_t n) override;
+  size_t ReadInto(std::span<Value> values) override;
+  bool Write(const Value &value) override;
+  size_t WriteN(const Values &values) override;
+  ValuesConstIterator WriteN(ValuesConstIterator begin, ValuesConstIterator end) override;
+  size_t WriteFrom(std::span<const Value> values) override;
+  bool MoveForward() override;
+  bool MoveBackward() override;
+  void MoveToBegin() override;
+  void MoveToEnd() override;
+  [[nodiscard]] std::chrono::microseconds GetElapsedTime() const override;
+
+  /**
+   * \brief Получить все значения ленты.
+   */
+  [[nodiscard]] const Values &GetValues() const;
+
+ private:
+  Values values_;
+  /// Позиция указателя.
+  size_t pos_ = 0;
+  std::optional<TapeLatency> latency_;
+
+  /**
+   * \brief Количество значений, доступных для чтения с текущей позиции.
+   */
+  [[nodiscard]] size_t Left() const;
+};
+
+template <typename Value>
+MemoryTape<Value>::MemoryTape(Values values) : values_(std::move(values)) {
+}
+
+template <typename Value>
+MemoryTape<Value>::MemoryTape(const Configuration &config, Values values)
+    : values_(std::move(values)), latency_(config) {
+}
+
+template <typename Value>
+std::optional<Value> MemoryTape<Value>::Read() {
+  if (latency_) {
+    latency_->Read(1);
+  }
+  if (Left() == 0) {
+    return std::nullopt;
+  }
+  return values_[pos_++];
+}
+
+template <typename Value>
+auto MemoryTape<Value>::ReadN(const size_t n) -> Values {
+  Values values(std::min(n, Left()));
+  ReadInto(values);
+  return values;
+}
+
+template <typename Value>
+size_t MemoryTape<Value>::ReadInto(std::span<Value> values) {
+  const auto count = std::min(values.size(), Left());
+  const auto begin = values_.begin() + static_cast<std::ptrdiff_t>(pos_);
+  std::copy_n(begin, count, values.begin());
+  pos_ += count;
+  if (latency_) {
+    latency_->Read(count);
+  }
+  return count;
+}
+
+template <typename Value>
+bool MemoryTape<Value>::Write(const Value &value) {
+  return WriteFrom({&value, 1}) == 1;
+}
+
+template <typename Value>
+size_t MemoryTape<Value>::WriteN(const Values &values) {
+  return WriteFrom(values);
+}
+
+template <typename Value>
+auto MemoryTape<Value>::WriteN(ValuesConstIterator begin, ValuesConstIterator end)
+    -> ValuesConstIterator {
+  return begin + static_cast<std::ptrdiff_t>(WriteFrom({begin, end}));
+}
+
+template <typename Value>
+size_t MemoryTape<Value>::WriteFrom(std::span<const Value> values) {
+  values_.resize(std::max(values_.size(), pos_ + values.size()));
+  std::ranges::copy(values, values_.begin() + static_cast<std::ptrdiff_t>(pos_));
+  pos_ += values.size();
+  if (latency_) {
+    latency_->Write(values.size());
+  }
+  return values.size();
+}
+
+template <typename Value>
+bool MemoryTape<Value>::MoveForward() {
+  ++pos_;
+  if (latency_) {
+    latency_->Move();
+  }
+  return true;
+}
+
+template <typename Value>
+bool MemoryTape<Value>::MoveBackward() {
+  if (pos_ == 0) {
+    return false;
+  }
+  --pos_;
+  if (latency_) {
+    latency_->Move();
+  }
+  return true;
+}
+
+template <typename Value>
+void MemoryTape<Value>::MoveToBegin() {
+  if (latency_) {
+    latency_->Rewind();
+  }
+  pos_ = 0;
+}
+
+template <typename Value>
+void MemoryTape<Value>::MoveToEnd() {
+  if (latency_) {
+    latency_->Rewind();
+  }
+  pos_ = values_.size();
+}
+
+template <typename Value>
+std::chrono::microseconds MemoryTape<Value>::GetElapsedTime() const {
+  return latency_ ? latency_->Elapsed() : std::chrono::microseconds{0};
+}
+
+template <typename Value>
+auto MemoryTape<Value>::GetValues() const -> const Values & {
+  return values_;
+}
+
+template <typename Value>
+size_t MemoryTape<Value>::Left() const {
+  return pos_ < values_.size() ? values_.size() - pos_ : 0;
+}
+
+}  // namespace sot
+
+#endif  // MEMORY_TAPE_H
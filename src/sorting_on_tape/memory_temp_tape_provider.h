@@ -0,0 +1,77 @@
+#ifndef MEMORY_TEMP_TAPE_PROVIDER_H
+#define MEMORY_TEMP_TAPE_PROVIDER_H
+
+#include "configuration.h"
+#include "memory_tape.h"
+#include "temp_tape_provider.h"
+
+namespace sot {
+
+/**
+ * \brief Класс, предоставляющий временные ленты в оперативной памяти.
+ *
+ * Предоставляет @link MemoryTape @endlink, данные которых освобождаются вместе с ними, поэтому
+ * файловая система не задействуется вовсе.
+ *
+ * \tparam Value тип элементов ленты.
+ */
+template <typename Value>
+class MemoryTempTapeProvider : public TempTapeProvider<Value> {
+ public:
+  /// Ключ в конфигурации, задающий объем памяти в байтах, который можно занять временными лентами
+  /// вместо файлов (0 - временные ленты всегда хранятся в файлах).
+  static constexpr auto kMemoryBudgetKey = "temp_tapes_memory_budget";
+
+  /// Значение объема памяти для временных лент по умолчанию.
+  static constexpr size_t kMemoryBudgetDefault = 0;
+
+  /**
+   * \brief Создать провайдер лент без эмуляции задержек.
+   */
+  MemoryTempTapeProvider() = default;
+  /**
+   * \brief Создать провайдер лент с эмуляцией задержек, заданных в конфигурации.
+   */
+  explicit MemoryTempTapeProvider(const Configuration &config);
+
+  /**
+   * \brief Проверить, помещаются ли временные ленты для сортировки данных заданного размера в
+   * объем памяти, заданный в конфигурации.
+   *
+   * Во время слияния одновременно существуют сливаемые ленты и результат их слияния, поэтому
+   * требуется вдвое больше памяти, чем занимают входные данные.
+   *
+   * \param input_size размер входных данных в байтах.
+   */
+  [[nodiscard]] static bool FitsIntoBudget(const Configuration &config, size_t input_size);
+
+  [[nodiscard]] std::unique_ptr<Tape<Value>> Get() const override;
+
+ private:
+  const Configuration *config_ = nullptr;
+};
+
+template <typename Value>
+MemoryTempTapeProvider<Value>::MemoryTempTapeProvider(const Configuration &config)
+    : config_(&config) {
+}
+
+template <typename Value>
+bool MemoryTempTapeProvider<Value>::FitsIntoBudget(
+    const Configuration &config, const size_t input_size
+) {
+  const auto budget = config.GetProperty(kMemoryBudgetKey, kMemoryBudgetDefault);
+  return budget > 0 && 2 * input_size <= budget;
+}
+
+template <typename Value>
+std::unique_ptr<Tape<Value>> MemoryTempTapeProvider<Value>::Get() const {
+  if (config_ == nullptr) {
+    return std::make_unique<MemoryTape<Value>>();
+  }
+  return std::make_unique<MemoryTape<Value>>(*config_);
+}
+
+}  // namespace sot
+
+#endif  // MEMORY_TEMP_TAPE_PROVIDER_H
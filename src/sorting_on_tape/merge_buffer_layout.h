@@ -0,0 +1,63 @@
+#ifndef MERGE_BUFFER_LAYOUT_H
+#define MERGE_BUFFER_LAYOUT_H
+
+#include <cstddef>
+
+namespace sot {
+
+/**
+ * \brief Деление памяти слияния между буферами серий, запасными буферами чтения по прогнозу и
+ * буфером записи.
+ *
+ * Одним и тем же делением пользуются @link TapeSorter @endlink при слиянии и
+ * @link SortCostModel модель стоимости@endlink при его предсказании.
+ */
+struct MergeBufferLayout {
+  /// Минимальный размер буфера серии при упреждающем чтении и отложенной записи: на меньших
+  /// блоках запуск фоновой операции обходится дороже ее самой.
+  static constexpr size_t kMinAsyncIoBlockSize = 1024;
+  /// Количество запасных буферов для чтения серий по прогнозу
+  /// (см. @link ForecastingRunReader @endlink).
+  static constexpr size_t kForecastSpareBufferCount = 4;
+
+  /// Количество значений буфера каждой серии и каждого запасного буфера.
+  size_t block_size = 0;
+  /// Читаются ли серии и пишется ли результат в фоне.
+  bool async_io = false;
+
+  /**
+   * \param memory количество значений памяти слияния;
+   * \param run_count количество сливаемых серий.
+   */
+  MergeBufferLayout(size_t memory, size_t run_count);
+
+  /**
+   * \brief Получить количество запасных буферов.
+   */
+  [[nodiscard]] size_t GetSpareCount() const;
+  /**
+   * \brief Получить количество значений буфера записи: при отложенной записи одна его половина
+   * пишется на ленту, пока заполняется другая.
+   */
+  [[nodiscard]] size_t GetWriteBufferSize() const;
+};
+
+inline MergeBufferLayout::MergeBufferLayout(const size_t memory, const size_t run_count)
+    : block_size(memory / (run_count + kForecastSpareBufferCount + 2)),
+      async_io(block_size >= kMinAsyncIoBlockSize) {
+  if (!async_io) {
+    block_size = memory / (run_count + 1);
+  }
+}
+
+inline size_t MergeBufferLayout::GetSpareCount() const {
+  return async_io ? kForecastSpareBufferCount : 0;
+}
+
+inline size_t MergeBufferLayout::GetWriteBufferSize() const {
+  return async_io ? 2 * block_size : block_size;
+}
+
+}  // namespace sot
+
+#endif  // MERGE_BUFFER_LAYOUT_H
@@ -0,0 +1,328 @@
+#ifndef MMAP_FILE_TAPE_H
+#define MMAP_FILE_TAPE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "configuration.h"
+#include "memory_literals.h"
+#include "tape.h"
+#include "tape_latency.h"
+
+namespace sot {
+
+using namespace memory_literals;
+
+/**
+ * \brief Эмулятор устройства типа ленты на основе отображенного в память файла.
+ *
+ * Чтение и запись сводятся к копированию из отображения и в него, а @link View @endlink позволяет
+ * читать значения вовсе без копирования. Неизменяемый файл отображается только для чтения, а
+ * изменяемый при необходимости увеличивается через ftruncate/mremap и при уничтожении ленты
+ * обрезается до фактически записанного размера. Задержки устройства задаются как в
+ * @link TapeLatency @endlink.
+ *
+ * \tparam Value тип данных для хранения на устройстве.
+ * \tparam Mutable можно ли изменять данные в файле.
+ */
+template <typename Value = int32_t, bool Mutable = true>
+class MmapFileTape : public Tape<Value> {
+ public:
+  /// Тип данных для хранения на устройстве.
+  using ValueT = typename Tape<Value>::ValueT;
+  /// Вектор, состоящий из элементов.
+  using Values = typename Tape<Value>::Values;
+  /// Итератор вектора из элементов.
+  using ValuesIterator = typename Tape<Value>::ValuesIterator;
+  /// Константный итератор вектора из элементов.
+  using ValuesConstIterator = typename Tape<Value>::ValuesConstIterator;
+
+  /// Минимальный размер отображения изменяемого файла в байтах.
+  static constexpr size_t kMinMappingSize = 1_MiB;
+
+  MmapFileTape(const Configuration &config, const std::string &file_name);
+  MmapFileTape(MmapFileTape &&other) noexcept;
+  MmapFileTape(const MmapFileTape &other) = delete;
+  MmapFileTape &operator=(const MmapFileTape &other) = delete;
+  MmapFileTape &operator=(MmapFileTape &&other) noexcept;
+  ~MmapFileTape() override;
+
+  std::optional<Value> Read() override;
+  Values ReadN(size_t n) override;
+  size_t ReadInto(std::span<Value> values) override;
+  /**
+   * \brief Прочитать указанное количество значений без копирования.
+   *
+   * При этом после выполнения операции указатель находится за последним прочитанным значением.
+   *
+   * \warning Представление действительно до следующей записи на ленту или ее уничтожения.
+   * \return представление прочитанных значений, которое может быть короче n, если достигнут
+   * конец ленты.
+   */
+  std::span<const Value> View(size_t n);
+  bool Write(const Value &value) override;
+  size_t WriteN(const Values &values) override;
+  ValuesConstIterator WriteN(ValuesConstIterator begin, ValuesConstIterator end) override;
+  size_t WriteFrom(std::span<const Value> values) override;
+  bool MoveForward() override;
+  bool MoveBackward() override;
+  void MoveToBegin() override;
+  void MoveToEnd() override;
+  [[nodiscard]] std::chrono::microseconds GetElapsedTime() const override;
+
+ private:
+  int fd_ = -1;
+  /// Начало отображения.
+  std::byte *data_ = nullptr;
+  /// Размер отображения в байтах.
+  size_t mapping_size_ = 0;
+  /// Фактический размер файла в байтах.
+  size_t file_size_ = 0;
+  /// Позиция указателя в значениях.
+  size_t pos_ = 0;
+  TapeLatency latency_;
+
+  /**
+   * \brief Количество значений, доступных для чтения с текущей позиции.
+   */
+  [[nodiscard]] size_t Left() const;
+  /**
+   * \brief Расширить отображение так, чтобы в него поместилось указанное количество байт.
+   * \return false - если расширить отображение не удалось.
+   */
+  bool Reserve(size_t size);
+  /**
+   * \brief Закрыть отображение и файл.
+   */
+  void Close() noexcept;
+};
+
+template <typename Value, bool Mutable>
+MmapFileTape<Value, Mutable>::MmapFileTape(
+    const Configuration &config, const std::string &file_name
+)
+    : latency_(config) {
+  const auto flags = Mutable ? O_RDWR | O_CREAT : O_RDONLY;
+  fd_ = open(file_name.c_str(), flags, 0644);
+  if (fd_ < 0) {
+    throw std::invalid_argument("Couldn't open the file with name '" + file_name + "'.");
+  }
+  struct stat file_stat {};
+  if (fstat(fd_, &file_stat) != 0) {
+    Close();
+    throw std::invalid_argument("Couldn't get the size of the file '" + file_name + "'.");
+  }
+  file_size_ = static_cast<size_t>(file_stat.st_size);
+  if (Mutable) {
+    if (!Reserve(std::max(file_size_, kMinMappingSize))) {
+      Close();
+      throw std::runtime_error("Couldn't map the file '" + file_name + "'.");
+    }
+  } else if (file_size_ > 0) {
+    void *data = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      Close();
+      throw std::runtime_error("Couldn't map the file '" + file_name + "'.");
+    }
+    data_ = static_cast<std::byte *>(data);
+    mapping_size_ = file_size_;
+  }
+  if (data_ != nullptr) {
+    madvise(data_, mapping_size_, MADV_SEQUENTIAL);
+  }
+}
+
+template <typename Value, bool Mutable>
+MmapFileTape<Value, Mutable>::MmapFileTape(MmapFileTape &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      data_(std::exchange(other.data_, nullptr)),
+      mapping_size_(std::exchange(other.mapping_size_, 0)),
+      file_size_(std::exchange(other.file_size_, 0)),
+      pos_(std::exchange(other.pos_, 0)),
+      latency_(other.latency_) {
+}
+
+template <typename Value, bool Mutable>
+auto MmapFileTape<Value, Mutable>::operator=(MmapFileTape &&other) noexcept -> MmapFileTape & {
+  if (this != &other) {
+    Close();
+    fd_ = std::exchange(other.fd_, -1);
+    data_ = std::exchange(other.data_, nullptr);
+    mapping_size_ = std::exchange(other.mapping_size_, 0);
+    file_size_ = std::exchange(other.file_size_, 0);
+    pos_ = std::exchange(other.pos_, 0);
+    latency_ = other.latency_;
+  }
+  return *this;
+}
+
+template <typename Value, bool Mutable>
+MmapFileTape<Value, Mutable>::~MmapFileTape() {
+  Close();
+}
+
+template <typename Value, bool Mutable>
+std::optional<Value> MmapFileTape<Value, Mutable>::Read() {
+  latency_.Read(1);
+  if (Left() == 0) {
+    return std::nullopt;
+  }
+  Value value;
+  std::memcpy(&value, data_ + pos_ * sizeof(Value), sizeof(Value));
+  ++pos_;
+  return value;
+}
+
+template <typename Value, bool Mutable>
+auto MmapFileTape<Value, Mutable>::ReadN(const size_t n) -> Values {
+  const auto values = View(n);
+  return {values.begin(), values.end()};
+}
+
+template <typename Value, bool Mutable>
+size_t MmapFileTape<Value, Mutable>::ReadInto(std::span<Value> values) {
+  const auto view = View(values.size());
+  // у пустого файла нет отображения, а memcpy с нулевым указателем не допускается даже для 0 байт
+  if (!view.empty()) {
+    std::memcpy(values.data(), view.data(), view.size_bytes());
+  }
+  return view.size();
+}
+
+template <typename Value, bool Mutable>
+std::span<const Value> MmapFileTape<Value, Mutable>::View(const size_t n) {
+  const auto count = std::min(n, Left());
+  latency_.Read(count);
+  if (count == 0) {
+    return {};
+  }
+  const auto *begin = reinterpret_cast<const Value *>(data_ + pos_ * sizeof(Value));
+  pos_ += count;
+  return {begin, count};
+}
+
+template <typename Value, bool Mutable>
+bool MmapFileTape<Value, Mutable>::Write(const Value &value) {
+  return WriteFrom({&value, 1}) == 1;
+}
+
+template <typename Value, bool Mutable>
+size_t MmapFileTape<Value, Mutable>::WriteN(const Values &values) {
+  return WriteFrom(values);
+}
+
+template <typename Value, bool Mutable>
+auto MmapFileTape<Value, Mutable>::WriteN(ValuesConstIterator begin, ValuesConstIterator end)
+    -> ValuesConstIterator {
+  return begin + static_cast<std::ptrdiff_t>(WriteFrom({begin, end}));
+}
+
+template <typename Value, bool Mutable>
+size_t MmapFileTape<Value, Mutable>::WriteFrom(std::span<const Value> values) {
+  size_t written = 0;
+  const auto end = (pos_ + values.size()) * sizeof(Value);
+  if (Mutable && !values.empty() && Reserve(end)) {
+    std::memcpy(data_ + pos_ * sizeof(Value), values.data(), values.size_bytes());
+    pos_ += values.size();
+    file_size_ = std::max(file_size_, end);
+    written = values.size();
+  }
+  latency_.Write(written);
+  return written;
+}
+
+template <typename Value, bool Mutable>
+bool MmapFileTape<Value, Mutable>::MoveForward() {
+  // изменяемую ленту, как и файл, можно сдвинуть за конец
+  if (!Mutable && Left() == 0) {
+    return false;
+  }
+  ++pos_;
+  latency_.Move();
+  return true;
+}
+
+template <typename Value, bool Mutable>
+bool MmapFileTape<Value, Mutable>::MoveBackward() {
+  if (pos_ == 0) {
+    return false;
+  }
+  --pos_;
+  latency_.Move();
+  return true;
+}
+
+template <typename Value, bool Mutable>
+void MmapFileTape<Value, Mutable>::MoveToBegin() {
+  latency_.Rewind();
+  pos_ = 0;
+}
+
+template <typename Value, bool Mutable>
+void MmapFileTape<Value, Mutable>::MoveToEnd() {
+  latency_.Rewind();
+  pos_ = file_size_ / sizeof(Value);
+}
+
+template <typename Value, bool Mutable>
+std::chrono::microseconds MmapFileTape<Value, Mutable>::GetElapsedTime() const {
+  return latency_.Elapsed();
+}
+
+template <typename Value, bool Mutable>
+size_t MmapFileTape<Value, Mutable>::Left() const {
+  const auto size = file_size_ / sizeof(Value);
+  return pos_ < size ? size - pos_ : 0;
+}
+
+template <typename Value, bool Mutable>
+bool MmapFileTape<Value, Mutable>::Reserve(const size_t size) {
+  if (size <= mapping_size_) {
+    return true;
+  }
+  const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  auto new_size = std::max(size, mapping_size_ * 2);
+  new_size = (new_size + page_size - 1) / page_size * page_size;
+  if (ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+    return false;
+  }
+  void *data = data_ == nullptr
+                   ? mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+                   : mremap(data_, mapping_size_, new_size, MREMAP_MAYMOVE);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  data_ = static_cast<std::byte *>(data);
+  mapping_size_ = new_size;
+  return true;
+}
+
+template <typename Value, bool Mutable>
+void MmapFileTape<Value, Mutable>::Close() noexcept {
+  if (data_ != nullptr) {
+    munmap(data_, mapping_size_);
+    data_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    if (Mutable) {
+      // отображение могло быть больше записанных данных
+      [[maybe_unused]] const auto result = ftruncate(fd_, static_cast<off_t>(file_size_));
+    }
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+}  // namespace sot
+
+#endif  // MMAP_FILE_TAPE_H
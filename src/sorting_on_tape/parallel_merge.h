@@ -0,0 +1,293 @@
+#ifndef PARALLEL_MERGE_H
+#define PARALLEL_MERGE_H
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "core/parallel_for.h"
+#include "loser_tree.h"
+#include "tape.h"
+
+namespace sot {
+
+/**
+ * \brief Параллельное k-путевое слияние отсортированных лент с разбиением по разделителям.
+ *
+ * Ленты допускают только последовательный доступ, поэтому слияние выполняется раундами над окнами
+ * в памяти. В каждом раунде окна всех источников параллельно дочитываются с их лент. Затем
+ * определяется граница - наименьшее из последних значений окон неисчерпанных источников: все
+ * значения окон, не превосходящие ее, уже можно выводить, так как следующие значения лент не
+ * меньше. Из этих префиксов окон выбираются разделители, которые делят их на части с
+ * непересекающимися диапазонами ключей, а бинарный поиск по каждому окну дает точное смещение
+ * каждой части в выходном буфере. Части сливаются параллельно деревом проигравших, после чего
+ * буфер записывается на выходную ленту.
+ *
+ * \tparam Value тип сливаемых значений.
+ * \tparam Comparator компаратор, задающий порядок значений.
+ * \tparam ThreadPool пул потоков, в который отправляются помощники
+ * (см. @link core::ParallelFor @endlink).
+ */
+template <typename Value, typename Comparator, typename ThreadPool>
+class ParallelMerger {
+ public:
+  using TapeSharedPtr = std::shared_ptr<Tape<Value>>;
+  using Duration = std::chrono::microseconds;
+
+  /// Количество элементов выборки на каждую часть.
+  static constexpr size_t kOversampling = 32;
+  /// Минимальное количество значений, сливаемых одним потоком за раунд.
+  static constexpr size_t kMinPartSize = 4096;
+
+  /**
+   * \param thread_pool пул потоков для помощников;
+   * \param comparator компаратор;
+   * \param worker_count количество потоков, выполняющих слияние, включая вызывающий;
+   * \param buffer_size количество значений в памяти: половина отводится под окна источников,
+   * половина - под выходной буфер.
+   */
+  ParallelMerger(
+      ThreadPool &thread_pool, Comparator comparator, size_t worker_count, size_t buffer_size
+  );
+
+  /**
+   * \brief Получить объем вспомогательной памяти в байтах, кроме buffer_size значений, которую
+   * занимает слияние заданного количества источников.
+   */
+  [[nodiscard]] static size_t GetMemoryUsage(size_t source_count, size_t worker_count);
+
+  /**
+   * \brief Слить ленты, начиная с их текущих позиций, и дописать результат на целевую ленту.
+   *
+   * \param sources отсортированные ленты, которые дочитываются до конца;
+   * \param target целевая лента.
+   * \return длина критического пути слияния по виртуальным часам лент: в каждом раунде источники
+   * читаются параллельно, а запись на целевую ленту следует за ними.
+   */
+  Duration Merge(const std::vector<TapeSharedPtr> &sources, Tape<Value> &target) const;
+
+ private:
+  /// Окно источника: [begin, end) - еще не выведенные значения.
+  struct Window {
+    std::vector<Value> values;
+    size_t begin = 0;
+    size_t end = 0;
+    bool exhausted = false;
+
+    [[nodiscard]] std::span<const Value> Pending() const {
+      return std::span(values).subspan(begin, end - begin);
+    }
+  };
+
+  ThreadPool &thread_pool_;
+  Comparator comparator_;
+  const size_t worker_count_;
+  const size_t buffer_size_;
+
+  /**
+   * \brief Выбрать разделители частей по равномерной выборке из сливаемых префиксов окон.
+   */
+  std::vector<Value> SelectSplitters(
+      const std::vector<std::span<const Value>> &prefixes, size_t total, size_t part_count
+  ) const;
+  /**
+   * \brief Слить участки источников в выходной буфер.
+   */
+  void MergePart(const std::vector<std::span<const Value>> &ranges, std::span<Value> output) const;
+};
+
+template <typename Value, typename Comparator, typename ThreadPool>
+ParallelMerger<Value, Comparator, ThreadPool>::ParallelMerger(
+    ThreadPool &thread_pool,
+    Comparator comparator,
+    const size_t worker_count,
+    const size_t buffer_size
+)
+    : thread_pool_(thread_pool),
+      comparator_(std::move(comparator)),
+      worker_count_(std::max<size_t>(1, worker_count)),
+      buffer_size_(buffer_size) {
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+size_t ParallelMerger<Value, Comparator, ThreadPool>::GetMemoryUsage(
+    const size_t source_count, const size_t worker_count
+) {
+  const auto part_count = std::max<size_t>(1, worker_count);
+  // окна, префиксы и время чтения источников, границы частей, выборка и разделители
+  const auto rounds = source_count * (sizeof(Window) + sizeof(std::span<const Value>) +
+                                      sizeof(Duration) + (part_count + 1) * sizeof(size_t)) +
+                      (part_count * kOversampling + part_count) * sizeof(Value);
+  // каждая часть сливается своим деревом по своим участкам источников
+  const auto parts =
+      part_count * (source_count * (sizeof(std::span<const Value>) + sizeof(size_t)) +
+                    LoserTree<Value, Comparator>::GetMemoryUsage(source_count));
+  return rounds + parts;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto ParallelMerger<Value, Comparator, ThreadPool>::Merge(
+    const std::vector<TapeSharedPtr> &sources, Tape<Value> &target
+) const -> Duration {
+  const auto source_count = sources.size();
+  if (source_count == 0) {
+    return Duration{0};
+  }
+  const auto window_size = buffer_size_ / (2 * source_count);
+  if (window_size == 0) {
+    throw std::invalid_argument("The buffer is too small to merge so many sources.");
+  }
+
+  std::vector<Window> windows(source_count);
+  for (auto &window : windows) {
+    window.values.resize(window_size);
+  }
+  std::vector<Value> output(window_size * source_count);
+  std::vector<Duration> read_times(source_count);
+  Duration critical_path{0};
+
+  while (true) {
+    // дочитать окна: ленты разные, поэтому читаются параллельно
+    core::ParallelFor(
+        thread_pool_,
+        source_count,
+        std::min(worker_count_, source_count),
+        [&](const size_t source) {
+          auto &window = windows[source];
+          if (window.exhausted) {
+            read_times[source] = Duration{0};
+            return;
+          }
+          const auto start = sources[source]->GetElapsedTime();
+          std::copy(
+              window.values.begin() + static_cast<std::ptrdiff_t>(window.begin),
+              window.values.begin() + static_cast<std::ptrdiff_t>(window.end),
+              window.values.begin()
+          );
+          window.end -= window.begin;
+          window.begin = 0;
+          const auto free = std::span(window.values).subspan(window.end);
+          const auto read = sources[source]->ReadInto(free);
+          window.end += read;
+          window.exhausted = read < free.size();
+          read_times[source] = sources[source]->GetElapsedTime() - start;
+        }
+    );
+    critical_path += std::ranges::max(read_times);
+
+    // неисчерпанные окна заполнены целиком, поэтому их последние значения определены
+    const Value *limit = nullptr;
+    for (const auto &window : windows) {
+      if (!window.exhausted && (!limit || comparator_(window.values.back(), *limit))) {
+        limit = &window.values.back();
+      }
+    }
+    std::vector<std::span<const Value>> prefixes(source_count);
+    size_t total = 0;
+    for (size_t source = 0; source < source_count; ++source) {
+      const auto pending = windows[source].Pending();
+      const auto end =
+          limit ? std::upper_bound(pending.begin(), pending.end(), *limit, comparator_)
+                : pending.end();
+      prefixes[source] = pending.first(static_cast<size_t>(end - pending.begin()));
+      total += prefixes[source].size();
+    }
+    if (total == 0) {
+      break;
+    }
+
+    const auto part_count = std::clamp<size_t>(total / kMinPartSize, 1, worker_count_);
+    const auto splitters = SelectSplitters(prefixes, total, part_count);
+    // bounds[part * source_count + source] - начало участка источника, относящегося к части
+    std::vector<size_t> bounds((part_count + 1) * source_count);
+    for (size_t source = 0; source < source_count; ++source) {
+      const auto prefix = prefixes[source];
+      for (size_t part = 1; part < part_count; ++part) {
+        const auto bound =
+            std::lower_bound(prefix.begin(), prefix.end(), splitters[part - 1], comparator_);
+        bounds[part * source_count + source] = static_cast<size_t>(bound - prefix.begin());
+      }
+      bounds[part_count * source_count + source] = prefix.size();
+    }
+    core::ParallelFor(thread_pool_, part_count, part_count, [&](const size_t part) {
+      std::vector<std::span<const Value>> ranges(source_count);
+      size_t offset = 0;
+      size_t size = 0;
+      for (size_t source = 0; source < source_count; ++source) {
+        const auto begin = bounds[part * source_count + source];
+        const auto end = bounds[(part + 1) * source_count + source];
+        offset += begin;
+        size += end - begin;
+        ranges[source] = prefixes[source].subspan(begin, end - begin);
+      }
+      MergePart(ranges, std::span(output).subspan(offset, size));
+    });
+
+    const auto write_start = target.GetElapsedTime();
+    target.WriteFrom(std::span(output).first(total));
+    critical_path += target.GetElapsedTime() - write_start;
+    for (size_t source = 0; source < source_count; ++source) {
+      windows[source].begin += prefixes[source].size();
+    }
+  }
+  return critical_path;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+std::vector<Value> ParallelMerger<Value, Comparator, ThreadPool>::SelectSplitters(
+    const std::vector<std::span<const Value>> &prefixes, const size_t total, const size_t part_count
+) const {
+  if (part_count < 2) {
+    return {};
+  }
+  // значения берутся с равным шагом из конкатенации префиксов: каждая серия представлена
+  // пропорционально своему вкладу
+  std::vector<Value> sample(std::min(total, part_count * kOversampling));
+  size_t source = 0;
+  size_t source_begin = 0;
+  for (size_t i = 0; i < sample.size(); ++i) {
+    const auto position = i * total / sample.size();
+    while (position >= source_begin + prefixes[source].size()) {
+      source_begin += prefixes[source++].size();
+    }
+    sample[i] = prefixes[source][position - source_begin];
+  }
+  std::sort(sample.begin(), sample.end(), comparator_);
+
+  std::vector<Value> splitters(part_count - 1);
+  for (size_t i = 0; i < splitters.size(); ++i) {
+    splitters[i] = sample[(i + 1) * sample.size() / part_count];
+  }
+  return splitters;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void ParallelMerger<Value, Comparator, ThreadPool>::MergePart(
+    const std::vector<std::span<const Value>> &ranges, std::span<Value> output
+) const {
+  std::vector<size_t> positions(ranges.size());
+  LoserTree<Value, Comparator> tree(ranges.size(), comparator_);
+  for (size_t source = 0; source < ranges.size(); ++source) {
+    if (!ranges[source].empty()) {
+      tree.Push(source, ranges[source].front());
+    }
+  }
+  tree.Build();
+
+  for (auto &value : output) {
+    value = tree.TopValue();
+    const auto source = tree.Top();
+    if (++positions[source] < ranges[source].size()) {
+      tree.ReplaceTop(ranges[source][positions[source]]);
+    } else {
+      tree.PopTop();
+    }
+  }
+}
+
+}  // namespace sot
+
+#endif  // PARALLEL_MERGE_H
@@ -0,0 +1,174 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <algorithm>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "core/parallel_for.h"
+
+namespace sot {
+
+/**
+ * \brief Параллельная сортировка выборкой (sample sort) на пуле потоков.
+ *
+ * По случайной выборке выбираются part_count - 1 разделителей. Затем значения делятся на
+ * part_count непрерывных частей, и каждая часть параллельно подсчитывает, сколько ее значений
+ * попадает в каждую корзину между разделителями, и раскладывает их во вспомогательный буфер так,
+ * что корзины идут по порядку. После этого корзины сортируются независимо заданной
+ * последовательной сортировкой, причем участок исходного массива, занимаемый корзиной, служит ей
+ * вспомогательным буфером, и копируются обратно.
+ *
+ * \tparam Value тип сортируемых значений.
+ * \tparam Comparator компаратор, задающий порядок сортировки.
+ * \tparam ThreadPool пул потоков, в который отправляются помощники
+ * (см. @link core::ParallelFor @endlink).
+ * \tparam SequentialSort функция, сортирующая значения (первый аргумент) с использованием
+ * вспомогательного буфера того же размера (второй аргумент).
+ */
+template <typename Value, typename Comparator, typename ThreadPool, typename SequentialSort>
+class ParallelSampleSorter {
+ public:
+  /// Количество элементов выборки на каждую корзину.
+  static constexpr size_t kOversampling = 32;
+
+  /**
+   * \param thread_pool пул потоков для помощников;
+   * \param comparator компаратор;
+   * \param sort последовательная сортировка корзин.
+   */
+  ParallelSampleSorter(ThreadPool &thread_pool, Comparator comparator, SequentialSort sort);
+
+  /**
+   * \brief Получить объем вспомогательной памяти в байтах, кроме буфера scratch, которую занимает
+   * сортировка на заданное количество частей.
+   */
+  [[nodiscard]] static size_t GetMemoryUsage(size_t part_count);
+
+  /**
+   * \brief Отсортировать значения.
+   *
+   * \param values сортируемые значения;
+   * \param scratch вспомогательный буфер не меньшего размера, его содержимое не сохраняется;
+   * \param part_count количество частей, на которые делится работа, и потоков, выполняющих ее.
+   */
+  void Sort(std::span<Value> values, std::span<Value> scratch, size_t part_count) const;
+
+ private:
+  ThreadPool &thread_pool_;
+  Comparator comparator_;
+  SequentialSort sort_;
+
+  /**
+   * \brief Выбрать разделители корзин по случайной выборке.
+   */
+  std::vector<Value> SelectSplitters(std::span<const Value> values, size_t bucket_count) const;
+  /**
+   * \brief Определить корзину значения.
+   */
+  size_t GetBucket(const std::vector<Value> &splitters, const Value &value) const;
+};
+
+template <typename Value, typename Comparator, typename ThreadPool, typename SequentialSort>
+ParallelSampleSorter<Value, Comparator, ThreadPool, SequentialSort>::ParallelSampleSorter(
+    ThreadPool &thread_pool, Comparator comparator, SequentialSort sort
+)
+    : thread_pool_(thread_pool), comparator_(std::move(comparator)), sort_(std::move(sort)) {
+}
+
+template <typename Value, typename Comparator, typename ThreadPool, typename SequentialSort>
+size_t ParallelSampleSorter<Value, Comparator, ThreadPool, SequentialSort>::GetMemoryUsage(
+    const size_t part_count
+) {
+  if (part_count < 2) {
+    return 0;
+  }
+  // смещения частей в корзинах и начала корзин, выборка и разделители
+  return (part_count * part_count + part_count + 1) * sizeof(size_t) +
+         (part_count * kOversampling + part_count - 1) * sizeof(Value);
+}
+
+template <typename Value, typename Comparator, typename ThreadPool, typename SequentialSort>
+void ParallelSampleSorter<Value, Comparator, ThreadPool, SequentialSort>::Sort(
+    std::span<Value> values, std::span<Value> scratch, size_t part_count
+) const {
+  if (scratch.size() < values.size()) {
+    throw std::invalid_argument("The scratch buffer is smaller than the values to sort.");
+  }
+  const auto size = values.size();
+  part_count = std::min(part_count, size);
+  if (part_count < 2) {
+    sort_(values, scratch.first(size));
+    return;
+  }
+
+  const auto splitters = SelectSplitters(values, part_count);
+  const auto part_begin = [size, part_count](const size_t part) {
+    return part * size / part_count;
+  };
+  // offsets[part * part_count + bucket] - позиция, с которой часть раскладывает значения корзины
+  std::vector<size_t> offsets(part_count * part_count);
+  core::ParallelFor(thread_pool_, part_count, part_count, [&](const size_t part) {
+    auto *const counts = &offsets[part * part_count];
+    for (auto i = part_begin(part); i < part_begin(part + 1); ++i) {
+      ++counts[GetBucket(splitters, values[i])];
+    }
+  });
+  std::vector<size_t> bucket_begins(part_count + 1);
+  size_t offset = 0;
+  for (size_t bucket = 0; bucket < part_count; ++bucket) {
+    bucket_begins[bucket] = offset;
+    for (size_t part = 0; part < part_count; ++part) {
+      offset += std::exchange(offsets[part * part_count + bucket], offset);
+    }
+  }
+  bucket_begins[part_count] = size;
+
+  core::ParallelFor(thread_pool_, part_count, part_count, [&](const size_t part) {
+    auto *const part_offsets = &offsets[part * part_count];
+    for (auto i = part_begin(part); i < part_begin(part + 1); ++i) {
+      scratch[part_offsets[GetBucket(splitters, values[i])]++] = values[i];
+    }
+  });
+  core::ParallelFor(thread_pool_, part_count, part_count, [&](const size_t bucket) {
+    const auto begin = bucket_begins[bucket];
+    const auto count = bucket_begins[bucket + 1] - begin;
+    const auto bucket_values = scratch.subspan(begin, count);
+    sort_(bucket_values, values.subspan(begin, count));
+    std::ranges::copy(bucket_values, values.begin() + static_cast<std::ptrdiff_t>(begin));
+  });
+}
+
+template <typename Value, typename Comparator, typename ThreadPool, typename SequentialSort>
+std::vector<Value>
+ParallelSampleSorter<Value, Comparator, ThreadPool, SequentialSort>::SelectSplitters(
+    std::span<const Value> values, const size_t bucket_count
+) const {
+  // фиксированное зерно делает разбиение воспроизводимым
+  std::mt19937_64 generator(values.size());
+  std::uniform_int_distribution<size_t> position(0, values.size() - 1);
+  std::vector<Value> sample(bucket_count * kOversampling);
+  std::ranges::generate(sample, [&]() { return values[position(generator)]; });
+  std::sort(sample.begin(), sample.end(), comparator_);
+
+  std::vector<Value> splitters(bucket_count - 1);
+  for (size_t i = 0; i < splitters.size(); ++i) {
+    splitters[i] = sample[(i + 1) * kOversampling];
+  }
+  return splitters;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool, typename SequentialSort>
+size_t ParallelSampleSorter<Value, Comparator, ThreadPool, SequentialSort>::GetBucket(
+    const std::vector<Value> &splitters, const Value &value
+) const {
+  const auto splitter = std::upper_bound(splitters.begin(), splitters.end(), value, comparator_);
+  return static_cast<size_t>(splitter - splitters.begin());
+}
+
+}  // namespace sot
+
+#endif  // PARALLEL_SORT_H
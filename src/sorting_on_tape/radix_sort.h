@@ -0,0 +1,141 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace sot {
+
+/**
+ * \brief Поразрядная сортировка (LSD) по 8-битным разрядам.
+ *
+ * Применима к целым числам и числам с плавающей точкой IEEE 754 размером до 8 байт при
+ * сортировке стандартными компараторами std::less и std::greater. Значения отображаются в
+ * беззнаковые ключи, порядок которых совпадает с порядком компаратора: у знаковых чисел
+ * инвертируется знаковый бит, у отрицательных чисел с плавающей точкой - все биты, а при
+ * сортировке по убыванию ключ инвертируется целиком. Гистограммы всех разрядов строятся за один
+ * проход, а разряды, одинаковые у всех значений, пропускаются.
+ *
+ * \tparam Value тип сортируемых значений.
+ * \tparam Comparator компаратор, задающий порядок сортировки.
+ */
+template <typename Value, typename Comparator = std::less<Value>>
+class RadixSorter {
+ public:
+  /// Можно ли отсортировать значения поразрядно, не нарушив порядок компаратора.
+  static constexpr bool kApplicable =
+      ((std::integral<Value> && !std::same_as<Value, bool>) ||
+       (std::floating_point<Value> && std::numeric_limits<Value>::is_iec559)) &&
+      sizeof(Value) <= sizeof(std::uint64_t) &&
+      (std::same_as<Comparator, std::less<Value>> || std::same_as<Comparator, std::less<>> ||
+       std::same_as<Comparator, std::greater<Value>> || std::same_as<Comparator, std::greater<>>);
+
+  /**
+   * \brief Отсортировать значения.
+   *
+   * \param values сортируемые значения;
+   * \param scratch вспомогательный буфер не меньшего размера, его содержимое не сохраняется.
+   */
+  static void Sort(std::span<Value> values, std::span<Value> scratch)
+    requires kApplicable;
+
+ private:
+  /// Беззнаковое целое того же размера, что и значение.
+  using Key = std::conditional_t<
+      sizeof(Value) == 1,
+      std::uint8_t,
+      std::conditional_t<
+          sizeof(Value) == 2,
+          std::uint16_t,
+          std::conditional_t<sizeof(Value) == 4, std::uint32_t, std::uint64_t>>>;
+
+  static constexpr bool kDescending =
+      std::same_as<Comparator, std::greater<Value>> || std::same_as<Comparator, std::greater<>>;
+  static constexpr size_t kDigitBits = 8;
+  static constexpr size_t kBucketCount = 1 << kDigitBits;
+  static constexpr size_t kDigitCount = sizeof(Value);
+  static constexpr Key kSignBit = Key{1} << (sizeof(Key) * 8 - 1);
+
+  /**
+   * \brief Отобразить значение в ключ, беззнаковый порядок которого совпадает с порядком
+   * компаратора.
+   */
+  static Key ToKey(Value value);
+  /**
+   * \brief Получить разряд ключа значения.
+   */
+  static size_t GetDigit(Value value, size_t digit);
+};
+
+template <typename Value, typename Comparator>
+void RadixSorter<Value, Comparator>::Sort(std::span<Value> values, std::span<Value> scratch)
+  requires kApplicable
+{
+  if (scratch.size() < values.size()) {
+    throw std::invalid_argument("The scratch buffer is smaller than the values to sort.");
+  }
+  const auto size = values.size();
+  if (size < 2) {
+    return;
+  }
+
+  std::array<std::array<size_t, kBucketCount>, kDigitCount> counts{};
+  for (const auto value : values) {
+    for (size_t digit = 0; digit < kDigitCount; ++digit) {
+      ++counts[digit][GetDigit(value, digit)];
+    }
+  }
+
+  auto *source = values.data();
+  auto *destination = scratch.data();
+  for (size_t digit = 0; digit < kDigitCount; ++digit) {
+    auto &offsets = counts[digit];
+    // все значения попадают в одну корзину, перестановка ничего не изменит
+    if (offsets[GetDigit(source[0], digit)] == size) {
+      continue;
+    }
+    size_t offset = 0;
+    for (auto &count : offsets) {
+      offset += std::exchange(count, offset);
+    }
+    for (size_t i = 0; i < size; ++i) {
+      destination[offsets[GetDigit(source[i], digit)]++] = source[i];
+    }
+    std::swap(source, destination);
+  }
+  if (source != values.data()) {
+    std::copy_n(source, size, values.data());
+  }
+}
+
+template <typename Value, typename Comparator>
+auto RadixSorter<Value, Comparator>::ToKey(const Value value) -> Key {
+  auto key = std::bit_cast<Key>(value);
+  if constexpr (std::floating_point<Value>) {
+    key = (key & kSignBit) != 0 ? static_cast<Key>(~key) : static_cast<Key>(key | kSignBit);
+  } else if constexpr (std::is_signed_v<Value>) {
+    key ^= kSignBit;
+  }
+  if constexpr (kDescending) {
+    key = static_cast<Key>(~key);
+  }
+  return key;
+}
+
+template <typename Value, typename Comparator>
+size_t RadixSorter<Value, Comparator>::GetDigit(const Value value, const size_t digit) {
+  return (ToKey(value) >> (digit * kDigitBits)) & (kBucketCount - 1);
+}
+
+}  // namespace sot
+
+#endif  // RADIX_SORT_H
@@ -0,0 +1,206 @@
+#include "sort_cost_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+
+#include "merge_buffer_layout.h"
+#include "tape_latency.h"
+
+namespace sot {
+
+namespace {
+
+double CeilDiv(const double value, const double divisor) {
+  return std::ceil(value / divisor);
+}
+
+}  // namespace
+
+SortCostModel::SortCostModel(const Configuration &config)
+    : read_(static_cast<double>(
+          config.GetProperty(TapeLatency::kReadDurationKey, TapeLatency::kReadDurationDefault) +
+          config.GetProperty(TapeLatency::kMoveDurationKey, TapeLatency::kMoveDurationDefault)
+      )),
+      write_(static_cast<double>(
+          config.GetProperty(TapeLatency::kWriteDurationKey, TapeLatency::kWriteDurationDefault) +
+          config.GetProperty(TapeLatency::kMoveDurationKey, TapeLatency::kMoveDurationDefault)
+      )),
+      rewind_(static_cast<double>(
+          config.GetProperty(TapeLatency::kRewindDurationKey, TapeLatency::kRewindDurationDefault)
+      )),
+      gap_cross_(static_cast<double>(config.GetProperty(
+          TapeLatency::kGapCrossDurationKey, TapeLatency::kGapCrossDurationDefault
+      ))) {
+}
+
+SortCostModel::Duration SortCostModel::Predict(
+    const size_t value_count, const SortPlan &plan, const SortLimits &limits
+) const {
+  return Duration(static_cast<Duration::rep>(EstimatePlan(value_count, plan, limits).time));
+}
+
+SortPlan SortCostModel::Choose(const size_t value_count, const SortLimits &limits) const {
+  std::optional<SortPlan> best;
+  double best_merged_values = 0;
+  for (size_t threads = 1; threads <= limits.max_thread_count; ++threads) {
+    const auto values_per_thread = std::min(
+        limits.max_values_per_thread, limits.values_in_memory / (limits.buffer_count * threads)
+    );
+    if (values_per_thread < 3) {
+      break;
+    }
+    // при ограниченной длине блока в памяти может уместиться больше потоков
+    const auto thread_count = std::min(
+        limits.max_thread_count, limits.values_in_memory / (values_per_thread * limits.buffer_count)
+    );
+    const auto max_group_size = std::min(limits.max_merging_group_size, values_per_thread - 1);
+    const auto consider = [&](const size_t group_size) {
+      SortPlan plan{values_per_thread, thread_count, group_size};
+      const auto estimate = EstimatePlan(value_count, plan, limits);
+      plan.predicted_time = Duration(static_cast<Duration::rep>(estimate.time));
+      // при равном времени меньше перечитываемых значений, а затем больше потоков
+      if (!best ||
+          std::tuple(plan.predicted_time, estimate.merged_values, best->thread_count) <
+              std::tuple(best->predicted_time, best_merged_values, plan.thread_count)) {
+        best = plan;
+        best_merged_values = estimate.merged_values;
+      }
+    };
+    for (size_t group_size = 2; group_size < max_group_size;
+         group_size = std::max(group_size + 1, group_size * 3 / 2)) {
+      consider(group_size);
+    }
+    // наибольшая группа проверяется отдельно: с ней все серии могут слиться за один проход
+    consider(max_group_size);
+  }
+  if (!best) {
+    throw std::invalid_argument("Can't plan sorting! Increase memory limit.");
+  }
+  return *best;
+}
+
+SortCostModel::Estimate SortCostModel::EstimatePlan(
+    const size_t value_count, const SortPlan &plan, const SortLimits &limits
+) const {
+  if (value_count == 0) {
+    return {};
+  }
+  const auto values = static_cast<double>(value_count);
+  const auto thread_count = static_cast<double>(plan.thread_count);
+  Estimate estimate;
+  double run_size = 0;
+  if (limits.initial_run_size == 0) {
+    // вход читается поблочно одним потоком
+    run_size = static_cast<double>(plan.values_per_thread);
+    const auto run_count = CeilDiv(values, run_size);
+    const auto input = values * read_ + run_count * gap_cross_;
+    if (run_count == 1) {
+      estimate.time = input + values * write_ + gap_cross_ + rewind_;
+      return estimate;
+    }
+    // блоки пишутся на временные ленты параллельно с чтением следующих, но не больше чем
+    // thread_count одновременно
+    const auto block_write = run_size * write_ + gap_cross_ + rewind_;
+    estimate.time = std::max(input, CeilDiv(run_count, thread_count) * block_write) + block_write;
+  } else {
+    // выбор с замещением читает вход и пишет серии по очереди блоками по 1/32 памяти
+    run_size = static_cast<double>(limits.initial_run_size);
+    const auto io_block = static_cast<double>(std::max<size_t>(1, limits.values_in_memory / 32));
+    estimate.time = values * (read_ + write_) + 2 * CeilDiv(values, io_block) * gap_cross_ +
+                    CeilDiv(values, run_size) * rewind_;
+    if (values <= run_size) {
+      return estimate;
+    }
+  }
+
+  // длины серий и их количество: все серии, кроме последней, одинаковой длины
+  std::map<double, size_t> runs;
+  const auto full_run_count = static_cast<size_t>(values / run_size);
+  runs[run_size] = full_run_count;
+  if (const auto rest = values - static_cast<double>(full_run_count) * run_size; rest > 0) {
+    ++runs[rest];
+  }
+  auto run_count = full_run_count + (runs.size() > 1 ? 1 : 0);
+  const auto group_size = plan.merging_group_size;
+  const auto merge_memory = plan.values_per_thread * limits.buffer_count;
+  // первое слияние объединяет столько самых коротких серий, чтобы все следующие были полными, как
+  // в TapeSorter::ParallelSortContext::GetMergeGroupSize
+  auto merged = (run_count - 2) % (group_size - 1) + 2;
+  while (run_count > group_size) {
+    auto smallest = runs.begin();
+    if (smallest->second >= merged) {
+      // независимые слияния серий одной длины выполняются параллельно, пока не останется
+      // последняя группа
+      const auto merge_count =
+          merged < group_size
+              ? 1
+              : std::min(smallest->second / merged, (run_count - group_size) / (group_size - 1));
+      const auto size = smallest->first;
+      const auto merge = PredictMerge(size, merged, merge_memory, false);
+      estimate.time += CeilDiv(static_cast<double>(merge_count), thread_count) * merge;
+      estimate.merged_values += static_cast<double>(merge_count * merged) * size;
+      smallest->second -= merge_count * merged;
+      if (smallest->second == 0) {
+        runs.erase(smallest);
+      }
+      runs[size * static_cast<double>(merged)] += merge_count;
+      run_count -= merge_count * (merged - 1);
+    } else {
+      // сливаются самые короткие серии разной длины
+      double merged_size = 0;
+      for (size_t taken = 0; taken < merged; smallest = runs.begin()) {
+        const auto take = std::min(merged - taken, smallest->second);
+        merged_size += smallest->first * static_cast<double>(take);
+        taken += take;
+        smallest->second -= take;
+        if (smallest->second == 0) {
+          runs.erase(smallest);
+        }
+      }
+      estimate.time +=
+          PredictMerge(merged_size / static_cast<double>(merged), merged, merge_memory, false);
+      estimate.merged_values += merged_size;
+      ++runs[merged_size];
+      run_count -= merged - 1;
+    }
+    merged = group_size;
+  }
+  // последнее слияние занимает всю память, а при нескольких потоках выполняется ими всеми
+  const auto parallel = plan.thread_count > 1;
+  estimate.time += PredictMerge(
+      values / static_cast<double>(run_count),
+      run_count,
+      parallel ? limits.values_in_memory : merge_memory,
+      parallel
+  );
+  estimate.merged_values += values;
+  return estimate;
+}
+
+double SortCostModel::PredictMerge(
+    const double run_size, const size_t run_count, const size_t memory, const bool parallel
+) const {
+  const auto merged_size = run_size * static_cast<double>(run_count);
+  if (parallel) {
+    // серии дочитываются в окна параллельно, после чего окна записываются на ленту
+    const auto window = static_cast<double>(std::max<size_t>(1, memory / 2 / run_count));
+    const auto rounds = CeilDiv(merged_size, static_cast<double>(std::max<size_t>(1, memory / 2)));
+    return run_size * read_ + merged_size * write_ +
+           (CeilDiv(run_size, window) + rounds) * gap_cross_ + 2 * rewind_;
+  }
+  // буфер делится между сериями так же, как в TapeSorter::MergeTapes
+  const MergeBufferLayout layout(memory, run_count);
+  const auto block = static_cast<double>(std::max<size_t>(1, layout.block_size));
+  const auto write_block = static_cast<double>(std::max<size_t>(1, layout.GetWriteBufferSize()));
+  const auto read = run_size * read_ + CeilDiv(run_size, block) * gap_cross_ + rewind_;
+  const auto write =
+      merged_size * write_ + CeilDiv(merged_size, write_block) * gap_cross_ + rewind_;
+  // с фоновым вводом-выводом слияние ограничено самой медленной лентой
+  return layout.async_io ? std::max(read, write) : static_cast<double>(run_count) * read + write;
+}
+
+}  // namespace sot
@@ -0,0 +1,122 @@
+#ifndef SORT_COST_MODEL_H
+#define SORT_COST_MODEL_H
+
+#include <chrono>
+#include <cstddef>
+
+#include "configuration.h"
+
+namespace sot {
+
+/**
+ * \brief Параметры сортировки, которые выбирает @link SortCostModel модель стоимости@endlink.
+ */
+struct SortPlan {
+  /// Длина блока начальных серий.
+  size_t values_per_thread = 0;
+  /// Количество потоков.
+  size_t thread_count = 0;
+  /// Количество серий, сливаемых одновременно.
+  size_t merging_group_size = 0;
+  /// Предсказанная длина критического пути сортировки.
+  std::chrono::microseconds predicted_time{0};
+};
+
+/**
+ * \brief Ограничения, в которых выбирается план сортировки.
+ */
+struct SortLimits {
+  /// Количество значений, умещающихся в лимит памяти.
+  size_t values_in_memory = 0;
+  /// Количество буферов по длине блока, необходимых для сортировки блока.
+  size_t buffer_count = 1;
+  /// Максимальная длина блока.
+  size_t max_values_per_thread = 0;
+  /// Максимальное количество потоков.
+  size_t max_thread_count = 1;
+  /// Максимальное количество серий, сливаемых одновременно.
+  size_t max_merging_group_size = 2;
+  /// Средняя длина начальных серий, если она не зависит от длины блока (при выборе с замещением
+  /// серии вдвое длиннее кучи и пишутся тем же потоком, что читает вход), иначе 0 - серии длиной в
+  /// блок. Длина естественных серий заранее неизвестна, поэтому они считаются блоками, как на
+  /// случайном входе.
+  size_t initial_run_size = 0;
+};
+
+/**
+ * \brief Модель стоимости внешней сортировки по задержкам ленточного устройства.
+ *
+ * Задержки берутся из тех же ключей конфигурации, что и в @link TapeLatency @endlink. Модель
+ * повторяет устройство @link TapeSorter @endlink: вход читается поблочно, блоки параллельно
+ * пишутся на временные ленты, серии сливаются по плану Хаффмана группами по merging_group_size, а
+ * буфер каждого слияния делится между сериями, поэтому с ростом количества сливаемых серий растет
+ * и количество преодолений межблочных промежутков.
+ */
+class SortCostModel {
+ public:
+  using Duration = std::chrono::microseconds;
+
+  explicit SortCostModel(const Configuration &config);
+
+  /**
+   * \brief Предсказать длину критического пути сортировки по плану.
+   *
+   * \param value_count количество сортируемых значений;
+   * \param plan план сортировки;
+   * \param limits ограничения, в которых выполняется сортировка.
+   */
+  [[nodiscard]] Duration Predict(
+      size_t value_count, const SortPlan &plan, const SortLimits &limits
+  ) const;
+  /**
+   * \brief Выбрать план с наименьшим предсказанным временем.
+   *
+   * Перебираются количество потоков, от которого зависит длина блока, и количество сливаемых
+   * серий в геометрической прогрессии. Из планов с равным временем (например, без задержек лент)
+   * выбирается план с меньшим количеством значений, перечитываемых при слиянии, а затем - с
+   * большим количеством потоков: задержки не учитывают вычислений, которые от этого сокращаются.
+   *
+   * \param value_count количество сортируемых значений;
+   * \param limits ограничения, в которых выполняется сортировка.
+   * \throws std::invalid_argument если в ограничениях нет ни одного допустимого плана.
+   */
+  [[nodiscard]] SortPlan Choose(size_t value_count, const SortLimits &limits) const;
+
+ private:
+  /// Предсказание сортировки по плану.
+  struct Estimate {
+    /// Длина критического пути.
+    double time = 0;
+    /// Суммарная длина серий всех слияний.
+    double merged_values = 0;
+  };
+
+  /// Стоимость чтения одного значения.
+  double read_;
+  /// Стоимость записи одного значения.
+  double write_;
+  double rewind_;
+  double gap_cross_;
+
+  /**
+   * \brief Предсказать длину критического пути и объем слияний сортировки по плану.
+   */
+  [[nodiscard]] Estimate EstimatePlan(
+      size_t value_count, const SortPlan &plan, const SortLimits &limits
+  ) const;
+  /**
+   * \brief Предсказать время одного слияния.
+   *
+   * \param run_size длина каждой из сливаемых серий;
+   * \param run_count количество сливаемых серий;
+   * \param memory количество значений буфера слияния;
+   * \param parallel сливается ли последняя группа всеми потоками.
+   */
+  [[nodiscard]] double PredictMerge(
+      double run_size, size_t run_count, size_t memory, bool parallel
+  ) const;
+};
+
+}  // namespace sot
+
+#endif  // SORT_COST_MODEL_H
@@ -1,8 +1,10 @@
 #ifndef TAPE_H
 #define TAPE_H
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace sot {
@@ -46,6 +48,17 @@ class Tape {
    * быть меньше чем n, если, например, достигнут конец ленты.
    */
   virtual Values ReadN(size_t n) = 0;
+  /**
+   * \brief Прочитать значения в переданный буфер.
+   *
+   * В отличие от @link ReadN @endlink не выделяет память: значения записываются в начало буфера.
+   * При этом после выполнения операции указатель находится за последним прочитанном значением.
+   *
+   * \param values буфер, размер которого задает максимальное количество читаемых значений.
+   * \return количество прочитанных значений, которое может быть меньше размера буфера, если,
+   * например, достигнут конец ленты.
+   */
+  virtual size_t ReadInto(std::span<Value> values) = 0;
   /**
    * \brief Записать значение на текущую позицию.
    *
@@ -71,6 +84,14 @@ class Tape {
    * были записаны все элементы.
    */
   virtual ValuesConstIterator WriteN(ValuesConstIterator begin, ValuesConstIterator end) = 0;
+  /**
+   * \brief Записать значения из переданного буфера, начиная с текущей позиции.
+   *
+   * При этом после выполнения операции указатель находится за последним записанным значением.
+   *
+   * \return количество записанных значений.
+   */
+  virtual size_t WriteFrom(std::span<const Value> values) = 0;
   /**
    * \brief Передвинуть указатель вперед на одну позицию.
    *
@@ -93,6 +114,15 @@ class Tape {
    * После выполнения операции указатель будет за последним элементом.
    */
   virtual void MoveToEnd() = 0;
+  /**
+   * \brief Суммарное время работы устройства по его виртуальным часам.
+   *
+   * Учитывает эмулированные задержки всех выполненных операций, даже если они не ожидались
+   * реально. Реализации без эмуляции задержек возвращают 0.
+   */
+  [[nodiscard]] virtual std::chrono::microseconds GetElapsedTime() const {
+    return {};
+  }
 };
 
 }  // namespace sot
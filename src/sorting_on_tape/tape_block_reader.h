@@ -1,22 +1,45 @@
 #ifndef TAPE_BLOCK_READER_H
 #define TAPE_BLOCK_READER_H
 
+#include <future>
 #include <memory>
+#include <span>
+#include <utility>
 
+#include "core/io_executor.h"
 #include "tape.h"
 
 namespace sot {
 
 /**
  * \brief Класс, позволяющий выполнять считывание с ленты с встроенной буфферизацией.
+ *
+ * С упреждающим чтением емкость делится на два буфера: пока значения читаются из одного, второй
+ * заполняется с ленты потоками ввода-вывода, и при исчерпании текущего буфера они меняются
+ * местами.
+ * Так чтение с ленты перекрывается с обработкой уже прочитанных значений, а память читателя
+ * по-прежнему не превышает заданной емкости.
+ *
  * \tparam Value тип элемента, хранимого на ленте.
  */
 template <typename Value>
 class TapeBlockReader {
  public:
-  TapeBlockReader(size_t capacity, std::shared_ptr<Tape<Value>> tape);
+  /**
+   * \param capacity суммарный размер буферов;
+   * \param tape лента, которая не должна использоваться напрямую, пока существует читатель;
+   * \param io_executor потоки упреждающего чтения, nullptr - чтение без упреждения; упреждающее
+   * чтение требует емкости не меньше 2, а потоки должны существовать дольше читателя.
+   */
+  TapeBlockReader(
+      size_t capacity, std::shared_ptr<Tape<Value>> tape, core::IoExecutor *io_executor = nullptr
+  );
   TapeBlockReader(TapeBlockReader &&other) = default;
-  TapeBlockReader &operator=(TapeBlockReader &&other) = default;
+  /**
+   * \brief Дожидается упреждающего чтения, так как его буфер освобождается.
+   */
+  TapeBlockReader &operator=(TapeBlockReader &&other) noexcept;
+  ~TapeBlockReader();
 
   /**
    * \brief Сдвинуть курсор вперед на одну позицию.
@@ -27,52 +50,158 @@ class TapeBlockReader {
    * \brief Прочитать значение на текущей позиции.
    */
   Value Read() const;
+  /**
+   * \brief Получить непрочитанные значения текущего блока.
+   *
+   * Значения остаются доступными до следующего сдвига курсора.
+   */
+  [[nodiscard]] std::span<const Value> ReadBlock() const;
+  /**
+   * \brief Перейти к следующему блоку, пропустив непрочитанные значения текущего.
+   * \return false - если достигнут конец устройства.
+   */
+  bool MoveToNextBlock();
+  /**
+   * \brief Проверить, достигнут ли конец устройства.
+   */
+  [[nodiscard]] bool IsEnd() const;
 
  private:
   using TapeSharedPtr = std::shared_ptr<Tape<Value>>;
 
-  size_t capacity_;
+  /// Количество значений, читаемых в фоне в буфер next_values_.
+  std::future<size_t> next_size_;
+  core::IoExecutor *io_executor_;
   TapeSharedPtr tape_;
+  /// Буфер фиксированного размера, выделяемый один раз.
   std::vector<Value> values_;
+  /// Буфер упреждающего чтения, пуст, если оно не выполняется.
+  std::vector<Value> next_values_;
+  /// Количество прочитанных в буфер значений.
+  size_t size_ = 0;
   size_t pos_ = 0;
 
   /**
    * \brief Выполнить чтение следующего блока с устройства.
    */
   void ReadNextBlock();
+  /**
+   * \brief Начать чтение следующего блока в фоне.
+   */
+  void StartPrefetch();
+  /**
+   * \brief Дождаться завершения упреждающего чтения, результат которого больше не нужен.
+   */
+  void WaitPrefetch() noexcept;
 };
 
 template <typename Value>
-TapeBlockReader<Value>::TapeBlockReader(const size_t capacity, std::shared_ptr<Tape<Value>> tape)
-    : capacity_(capacity), tape_(std::move(tape)) {
+TapeBlockReader<Value>::TapeBlockReader(
+    const size_t capacity, std::shared_ptr<Tape<Value>> tape, core::IoExecutor *io_executor
+)
+    : io_executor_(io_executor), tape_(std::move(tape)) {
   if (capacity == 0) {
     throw std::runtime_error("Capacity must be positive.");
   }
+  if (io_executor_ && capacity >= 2) {
+    values_.resize(capacity / 2);
+    next_values_.resize(capacity / 2);
+  } else {
+    values_.resize(capacity);
+  }
   ReadNextBlock();
 }
 
+template <typename Value>
+auto TapeBlockReader<Value>::operator=(TapeBlockReader &&other) noexcept -> TapeBlockReader & {
+  if (this != &other) {
+    WaitPrefetch();
+    next_size_ = std::move(other.next_size_);
+    io_executor_ = other.io_executor_;
+    tape_ = std::move(other.tape_);
+    values_ = std::move(other.values_);
+    next_values_ = std::move(other.next_values_);
+    size_ = std::exchange(other.size_, 0);
+    pos_ = std::exchange(other.pos_, 0);
+  }
+  return *this;
+}
+
+template <typename Value>
+TapeBlockReader<Value>::~TapeBlockReader() {
+  WaitPrefetch();
+}
+
 template <typename Value>
 bool TapeBlockReader<Value>::MoveForward() {
   ++pos_;
-  if (pos_ == values_.size()) {
+  if (pos_ == size_) {
     ReadNextBlock();
-    return !values_.empty();
+    return size_ != 0;
   }
   return true;
 }
 
 template <typename Value>
 Value TapeBlockReader<Value>::Read() const {
-  if (pos_ >= values_.size()) {
+  if (pos_ >= size_) {
     throw std::runtime_error("Tried to read out of bounds.");
   }
   return values_[pos_];
 }
 
+template <typename Value>
+std::span<const Value> TapeBlockReader<Value>::ReadBlock() const {
+  if (IsEnd()) {
+    return {};
+  }
+  return std::span<const Value>(values_).subspan(pos_, size_ - pos_);
+}
+
+template <typename Value>
+bool TapeBlockReader<Value>::MoveToNextBlock() {
+  if (size_ == 0) {
+    return false;
+  }
+  ReadNextBlock();
+  return size_ != 0;
+}
+
+template <typename Value>
+bool TapeBlockReader<Value>::IsEnd() const {
+  return pos_ >= size_;
+}
+
 template <typename Value>
 void TapeBlockReader<Value>::ReadNextBlock() {
-  values_ = tape_->ReadN(capacity_);
+  if (next_size_.valid()) {
+    size_ = next_size_.get();
+    std::swap(values_, next_values_);
+  } else {
+    size_ = tape_->ReadInto(values_);
+  }
   pos_ = 0;
+  // неполный блок означает конец ленты
+  if (!next_values_.empty() && size_ == values_.size()) {
+    StartPrefetch();
+  }
+}
+
+template <typename Value>
+void TapeBlockReader<Value>::StartPrefetch() {
+  // буфер вектора не перемещается ни при обмене, ни при перемещении читателя
+  next_size_ = io_executor_->Submit([tape = tape_, buffer = std::span(next_values_)]() {
+    return tape->ReadInto(buffer);
+  });
+}
+
+template <typename Value>
+void TapeBlockReader<Value>::WaitPrefetch() noexcept {
+  // будущий результат потоков ввода-вывода не дожидается операции при уничтожении, а ее буфер
+  // освобождается вместе с читателем
+  if (next_size_.valid()) {
+    next_size_.wait();
+  }
 }
 
 }  // namespace sot
@@ -1,22 +1,57 @@
 #ifndef TAPE_BLOCK_WRITER_H
 #define TAPE_BLOCK_WRITER_H
 
+#include <algorithm>
+#include <future>
+#include <iostream>
 #include <memory>
+#include <span>
+#include <utility>
+#include <vector>
 
+#include "core/io_executor.h"
 #include "tape.h"
 
 namespace sot {
 
 /**
  * \brief Класс, позволяющий выполнять запись на ленту с встроенной буфферизацией.
+ *
+ * При отложенной записи емкость делится на два буфера: заполненный буфер записывается на ленту
+ * потоком ввода-вывода, а значения тем временем добавляются во второй. Так запись на ленту
+ * перекрывается с вычислением следующих значений, а память писателя по-прежнему не превышает
+ * заданной емкости.
+ *
  * \tparam Value тип элемента, хранимого на ленте.
  */
 template <typename Value>
 class TapeBlockWriter {
  public:
-  TapeBlockWriter(size_t capacity, std::shared_ptr<Tape<Value>> tape);
+  /**
+   * \param capacity суммарный размер буферов;
+   * \param tape лента, которая не должна использоваться напрямую до вызова @link Flush @endlink;
+   * \param io_executor потоки отложенной записи, nullptr - синхронная запись; отложенная запись
+   * требует емкости не меньше 2, а потоки должны существовать дольше писателя.
+   */
+  TapeBlockWriter(
+      size_t capacity, std::shared_ptr<Tape<Value>> tape, core::IoExecutor *io_executor = nullptr
+  );
+  /**
+   * \brief Создать писателя, буферы которого размещаются во внешней памяти.
+   *
+   * \param buffer память буферов, которая должна существовать дольше писателя.
+   */
+  TapeBlockWriter(
+      std::span<Value> buffer,
+      std::shared_ptr<Tape<Value>> tape,
+      core::IoExecutor *io_executor = nullptr
+  );
   TapeBlockWriter(TapeBlockWriter &&other) = default;
-  TapeBlockWriter &operator=(TapeBlockWriter &&other) = default;
+  /**
+   * \brief Как и деструктор, записывает данные буфера и дожидается фоновой записи, так как ее
+   * буфер освобождается, но ошибку записи пробрасывает.
+   */
+  TapeBlockWriter &operator=(TapeBlockWriter &&other);
   ~TapeBlockWriter();
 
   /**
@@ -24,68 +59,163 @@ class TapeBlockWriter {
    */
   void Write(Value value);
   /**
-   * \brief Принудительно отправить данные из буфера и очистить его.
+   * \brief Записать значения подряд, копируя их в буфер целыми частями.
+   */
+  void WriteFrom(std::span<const Value> values);
+  /**
+   * \brief Принудительно отправить данные из буфера, очистить его и дождаться завершения записи.
+   *
+   * Ошибка отложенной записи пробрасывается отсюда.
    */
   void Flush();
 
  private:
   using TapeSharedPtr = std::shared_ptr<Tape<Value>>;
 
-  size_t capacity_;
+  /// Фоновая запись буфера written_values_.
+  std::future<void> writing_;
+  core::IoExecutor *io_executor_;
   TapeSharedPtr tape_;
-  std::vector<Value> values_;
+  /// Собственная память буферов, пуста, если они размещаются во внешней памяти.
+  std::vector<Value> storage_;
+  /// Буфер фиксированного размера.
+  std::span<Value> values_;
+  /// Буфер, записываемый в фоне, пуст, если отложенная запись не выполняется.
+  std::span<Value> written_values_;
+  /// Количество значений в буфере.
   size_t pos_ = 0;
 
+  /**
+   * \brief Разместить буферы в заданной памяти.
+   */
+  void SetBuffer(std::span<Value> buffer);
   /**
    * \brief Записать буфер данных и очистить его.
    */
   void WriteBlock();
   /**
-   * \brief Сдвинуть курсор на одну позицию вперед.
+   * \brief Дождаться завершения фоновой записи и пробросить ее ошибку.
    */
-  void MoveForward();
+  void WaitWriting();
 };
 
 template <typename Value>
-TapeBlockWriter<Value>::TapeBlockWriter(const size_t capacity, std::shared_ptr<Tape<Value>> tape)
-    : capacity_(capacity), tape_(std::move(tape)) {
-  if (capacity == 0) {
-    throw std::runtime_error("Capacity must be positive.");
+TapeBlockWriter<Value>::TapeBlockWriter(
+    const size_t capacity, std::shared_ptr<Tape<Value>> tape, core::IoExecutor *io_executor
+)
+    : io_executor_(io_executor), tape_(std::move(tape)), storage_(capacity) {
+  SetBuffer(storage_);
+}
+
+template <typename Value>
+TapeBlockWriter<Value>::TapeBlockWriter(
+    std::span<Value> buffer, std::shared_ptr<Tape<Value>> tape, core::IoExecutor *io_executor
+)
+    : io_executor_(io_executor), tape_(std::move(tape)) {
+  SetBuffer(buffer);
+}
+
+template <typename Value>
+auto TapeBlockWriter<Value>::operator=(TapeBlockWriter &&other) -> TapeBlockWriter & {
+  if (this != &other) {
+    if (tape_) {
+      Flush();
+    }
+    writing_ = std::move(other.writing_);
+    io_executor_ = other.io_executor_;
+    tape_ = std::move(other.tape_);
+    storage_ = std::move(other.storage_);
+    values_ = other.values_;
+    written_values_ = other.written_values_;
+    pos_ = std::exchange(other.pos_, 0);
   }
-  values_.reserve(capacity);
+  return *this;
 }
 
 template <typename Value>
 TapeBlockWriter<Value>::~TapeBlockWriter() {
-  Flush();
+  // у перемещенного объекта нет ни устройства, ни данных
+  if (!tape_) {
+    return;
+  }
+  // деструктор не должен бросать исключения, поэтому ошибка только сообщается
+  try {
+    Flush();
+  } catch (const std::exception &ex) {
+    std::cerr << "Couldn't flush the tape block writer: " << ex.what() << '\n';
+  } catch (...) {
+    std::cerr << "Couldn't flush the tape block writer\n";
+  }
 }
 
 template <typename Value>
 void TapeBlockWriter<Value>::Write(Value value) {
-  values_.emplace_back(std::move(value));
-  MoveForward();
+  values_[pos_++] = std::move(value);
+  if (pos_ == values_.size()) {
+    WriteBlock();
+  }
+}
+
+template <typename Value>
+void TapeBlockWriter<Value>::WriteFrom(std::span<const Value> values) {
+  while (!values.empty()) {
+    const auto count = std::min(values.size(), values_.size() - pos_);
+    std::ranges::copy(values.first(count), values_.begin() + static_cast<std::ptrdiff_t>(pos_));
+    pos_ += count;
+    values = values.subspan(count);
+    if (pos_ == values_.size()) {
+      WriteBlock();
+    }
+  }
 }
 
 template <typename Value>
 void TapeBlockWriter<Value>::Flush() {
-  WriteBlock();
+  if (pos_ != 0) {
+    WriteBlock();
+  }
+  WaitWriting();
+}
+
+template <typename Value>
+void TapeBlockWriter<Value>::SetBuffer(std::span<Value> buffer) {
+  if (buffer.empty()) {
+    throw std::runtime_error("Capacity must be positive.");
+  }
+  if (io_executor_ && buffer.size() >= 2) {
+    values_ = buffer.first(buffer.size() / 2);
+    written_values_ = buffer.subspan(buffer.size() / 2, buffer.size() / 2);
+  } else {
+    values_ = buffer;
+  }
 }
 
 template <typename Value>
 void TapeBlockWriter<Value>::WriteBlock() {
-  const auto written = tape_->WriteN(values_);
-  if (written != values_.size()) {
-    throw std::runtime_error("Can't write to tape.");
+  const auto write = [](Tape<Value> &tape, std::span<const Value> values) {
+    if (tape.WriteFrom(values) != values.size()) {
+      throw std::runtime_error("Can't write to tape.");
+    }
+  };
+  if (written_values_.empty()) {
+    write(*tape_, {values_.data(), pos_});
+  } else {
+    // память буферов не перемещается при перемещении писателя
+    WaitWriting();
+    std::swap(values_, written_values_);
+    writing_ = io_executor_->Submit(
+        [write, tape = tape_, values = std::span<const Value>(written_values_.first(pos_))]() {
+          write(*tape, values);
+        }
+    );
   }
-  values_.clear();
   pos_ = 0;
 }
 
 template <typename Value>
-void TapeBlockWriter<Value>::MoveForward() {
-  ++pos_;
-  if (pos_ > capacity_) {
-    WriteBlock();
+void TapeBlockWriter<Value>::WaitWriting() {
+  if (writing_.valid()) {
+    writing_.get();
   }
 }
 
@@ -0,0 +1,52 @@
+#include "tape_latency.h"
+
+#include <format>
+#include <stdexcept>
+#include <thread>
+
+namespace sot {
+
+TapeLatency::TapeLatency(const Configuration &config)
+    : mode_(static_cast<LatencyMode>(
+          config.GetProperty(kLatencyModeKey, static_cast<std::uint64_t>(kLatencyModeDefault))
+      )),
+      read_duration_(config.GetProperty(kReadDurationKey, kReadDurationDefault)),
+      write_duration_(config.GetProperty(kWriteDurationKey, kWriteDurationDefault)),
+      move_duration_(config.GetProperty(kMoveDurationKey, kMoveDurationDefault)),
+      rewind_duration_(config.GetProperty(kRewindDurationKey, kRewindDurationDefault)),
+      gap_cross_duration_(config.GetProperty(kGapCrossDurationKey, kGapCrossDurationDefault)) {
+  if (mode_ != LatencyMode::kSleep && mode_ != LatencyMode::kVirtualClock) {
+    throw std::invalid_argument(
+        std::format("Unknown latency mode: {}.", static_cast<std::uint64_t>(mode_))
+    );
+  }
+}
+
+void TapeLatency::Read(const size_t count) {
+  Delay(count * (read_duration_ + move_duration_) + gap_cross_duration_);
+}
+
+void TapeLatency::Write(const size_t count) {
+  Delay(count * (write_duration_ + move_duration_) + gap_cross_duration_);
+}
+
+void TapeLatency::Move() {
+  Delay(move_duration_);
+}
+
+void TapeLatency::Rewind() {
+  Delay(rewind_duration_);
+}
+
+TapeLatency::Duration TapeLatency::Elapsed() const {
+  return elapsed_;
+}
+
+void TapeLatency::Delay(const Duration duration) {
+  elapsed_ += duration;
+  if (mode_ == LatencyMode::kSleep) {
+    std::this_thread::sleep_for(duration);
+  }
+}
+
+}  // namespace sot
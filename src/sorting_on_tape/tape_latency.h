@@ -0,0 +1,109 @@
+#ifndef TAPE_LATENCY_H
+#define TAPE_LATENCY_H
+
+#include <chrono>
+#include <cstdint>
+
+#include "configuration.h"
+
+namespace sot {
+
+/**
+ * \brief Способ эмуляции задержек устройства.
+ */
+enum class LatencyMode : std::uint64_t {
+  /// Поток, выполняющий операцию, засыпает на время задержки.
+  kSleep = 0,
+  /// Задержки только суммируются в виртуальных часах ленты, без ожидания.
+  kVirtualClock = 1,
+};
+
+/**
+ * \brief Эмуляция задержек ленточного устройства.
+ *
+ * Задержки задаются в конфигурации и одинаковы для всех реализаций лент. Независимо от
+ * @link LatencyMode способа эмуляции@endlink все задержки накапливаются в виртуальных часах
+ * (см. @link Elapsed @endlink), что позволяет оценивать время работы устройства без реального
+ * ожидания.
+ */
+class TapeLatency {
+ public:
+  /// Единицы измерения "задержек" устройства.
+  using Duration = std::chrono::microseconds;
+
+  /// Ключ в конфигурации, задающий @link LatencyMode способ эмуляции задержек@endlink.
+  static constexpr auto kLatencyModeKey = "latency_mode";
+
+  /// Ключ в конфигурации,
+  /// задающий задержку чтения с устройства в @link Duration заданных единицах@endlink.
+  static constexpr auto kReadDurationKey = "read_duration";
+  /// Ключ в конфигурации,
+  /// задающий задержку записи на устройства в @link Duration заданных единицах@endlink.
+  static constexpr auto kWriteDurationKey = "write_duration";
+  /// Ключ в конфигурации,
+  /// задающий задержку сдвига ленты на одну позицию в @link Duration заданных единицах@endlink.
+  static constexpr auto kMoveDurationKey = "move_duration";
+  /// Ключ в конфигурации,
+  /// задающий задержку перемотки ленты в @link Duration заданных единицах@endlink.
+  static constexpr auto kRewindDurationKey = "rewind_duration";
+  /// Ключ в конфигурации,
+  /// задающий задержку преодоления межблочного промежутка ленты в @link Duration заданных
+  /// единицах@endlink.
+  static constexpr auto kGapCrossDurationKey = "gap_cross_duration";
+
+  /// Значение задержки чтения по умолчанию в @link Duration заданных единицах@endlink.
+  static constexpr auto kReadDurationDefault = 7;
+  /// Значение задержки записи по умолчанию в @link Duration заданных единицах@endlink.
+  static constexpr auto kWriteDurationDefault = 7;
+  /// Значение задержки сдвига по умолчанию в @link Duration заданных единицах@endlink.
+  static constexpr auto kMoveDurationDefault = 1;
+  /// Значение задержки перемотки по умолчанию в @link Duration заданных единицах@endlink.
+  static constexpr auto kRewindDurationDefault = 1000;
+  /// Значение задержки преодоления межблочного промежутка по умолчанию в @link Duration заданных
+  /// единицах@endlink.
+  static constexpr auto kGapCrossDurationDefault = 200;
+  /// Способ эмуляции задержек по умолчанию.
+  static constexpr auto kLatencyModeDefault = LatencyMode::kSleep;
+
+  explicit TapeLatency(const Configuration &config);
+
+  /**
+   * \brief Задержка чтения указанного количества значений за одну операцию.
+   */
+  void Read(size_t count);
+  /**
+   * \brief Задержка записи указанного количества значений за одну операцию.
+   */
+  void Write(size_t count);
+  /**
+   * \brief Задержка сдвига ленты на одну позицию.
+   */
+  void Move();
+  /**
+   * \brief Задержка перемотки ленты.
+   */
+  void Rewind();
+  /**
+   * \brief Суммарное время всех эмулированных операций.
+   */
+  [[nodiscard]] Duration Elapsed() const;
+
+ private:
+  LatencyMode mode_;
+  /// Виртуальные часы устройства.
+  Duration elapsed_{0};
+  Duration read_duration_;
+  Duration write_duration_;
+  Duration move_duration_;
+  Duration rewind_duration_;
+  Duration gap_cross_duration_;
+
+  /**
+   * \brief Учесть задержку операции.
+   */
+  void Delay(Duration duration);
+};
+
+}  // namespace sot
+
+#endif  // TAPE_LATENCY_H
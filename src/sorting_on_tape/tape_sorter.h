@@ -2,13 +2,26 @@
 #define TAPE_SORTING_H
 
 #include <algorithm>
-#include <execution>
+#include <chrono>
 #include <format>
-#include <queue>
+#include <functional>
+#include <map>
+#include <set>
 
 #include "configuration.h"
+#include "core/buffer_pool.h"
+#include "core/io_executor.h"
+#include "core/memory_governor.h"
+#include "core/simd_sort.h"
 #include "core/thread_pool.h"
+#include "forecasting_run_reader.h"
+#include "loser_tree.h"
 #include "memory_literals.h"
+#include "merge_buffer_layout.h"
+#include "parallel_merge.h"
+#include "parallel_sort.h"
+#include "radix_sort.h"
+#include "sort_cost_model.h"
 #include "tape.h"
 #include "tape_block_reader.h"
 #include "tape_block_writer.h"
@@ -18,6 +31,36 @@ namespace sot {
 
 using namespace memory_literals;
 
+/**
+ * \brief Способ формирования начальных отсортированных серий.
+ */
+enum class RunFormationMode : std::uint64_t {
+  /// Вход делится на блоки фиксированного размера, каждый из которых сортируется отдельно.
+  kFixedBlocks = 0,
+  /// Выбор с замещением: серии в среднем вдвое длиннее доступной памяти.
+  kReplacementSelection = 1,
+  /// Естественные серии: уже упорядоченные участки входа продолжают серию через границы блоков, а
+  /// сортируются только неупорядоченные блоки.
+  kNaturalRuns = 2,
+};
+
+/**
+ * \brief Статистика сортировки по виртуальным часам лент (см. @link Tape::GetElapsedTime @endlink).
+ */
+struct SortStatistics {
+  /// Суммарное время работы всех задействованных лент.
+  std::chrono::microseconds device_time{0};
+  /// Длина критического пути: время сортировки при неограниченном количестве потоков, если
+  /// операции над разными лентами выполняются параллельно.
+  std::chrono::microseconds critical_path{0};
+  /// Наибольший объем памяти в байтах, который одновременно занимали буферы блоков и слияний пула,
+  /// включая свободные.
+  size_t peak_buffer_memory = 0;
+  /// План, выбранный @link SortCostModel моделью стоимости@endlink при автоматической настройке,
+  /// вместе с предсказанной длиной критического пути.
+  std::optional<SortPlan> plan;
+};
+
 /**
  * \brief Класс, реализующий сортировку данных с входной ленты на выходную.
  * \tparam Value тип элементов ленты.
@@ -36,16 +79,29 @@ class TapeSorter {
   static constexpr auto kMaxThreadCountKey = "max_thread_count";
   /// Ключ в конфигурации, задающий максимальное количество обрабатываемых значений одним потоком.
   static constexpr auto kMaxValueCountPerThreadKey = "max_value_count_per_thread";
+  /// Ключ в конфигурации, задающий @link RunFormationMode способ формирования серий@endlink.
+  static constexpr auto kRunFormationModeKey = "run_formation_mode";
   /// Ключ в конфигурации, задающий максимальное количество блоков, сливаемых одновременно.
   static constexpr auto kMaxMerginGroupSizeKey = "max_merging_group_size";
+  /// Ключ в конфигурации, включающий размещение буферов блоков на больших страницах.
+  static constexpr auto kHugePageBuffersKey = "huge_page_buffers";
+  /// Ключ в конфигурации, включающий автоматический выбор длины блока, количества сливаемых серий
+  /// и потоков по @link SortCostModel модели стоимости@endlink.
+  static constexpr auto kAutoTuneKey = "auto_tune";
   /// Значение лимита использования занимаемой памяти при сортировке по умолчанию.
   static constexpr size_t kDefaultMemoryLimit = 1_GiB;
   /// Значение количества потоков, используемых при сортировке, по умолчанию hardware_concurrency.
   static const size_t kDefaultMaxThreadCount;
   /// Максимальное количество элементов, которое может обрабатывать один поток.
   static constexpr size_t kDefaultMaxValueCountPerThread = 1000000;
+  /// Способ формирования серий по умолчанию.
+  static constexpr auto kDefaultRunFormationMode = RunFormationMode::kFixedBlocks;
   /// Максимальное количество блоков, сливаемых одновременно.
   static constexpr size_t kDefaultMaxMergingGroupSize = 50;
+  /// Размещать ли буферы блоков на больших страницах по умолчанию.
+  static constexpr std::uint64_t kDefaultHugePageBuffers = 0;
+  /// Выполнять ли автоматическую настройку по умолчанию.
+  static constexpr std::uint64_t kDefaultAutoTune = 0;
 
   TapeSorter(
       const Configuration &config,
@@ -56,59 +112,182 @@ class TapeSorter {
   /**
    * \brief Выполнить сортировку данных с входной ленты.
    *
-   * Результат выводится в выходную ленту.
+   * Результат выводится в выходную ленту. При автоматической настройке и известном количестве
+   * входных значений длина блока, количество сливаемых серий и потоков выбираются моделью
+   * стоимости в пределах ограничений конфигурации, иначе используются сами ограничения.
    *
    * \param[in] input_tape входная лента;
-   * \param[out] output_tape выходная лента.
+   * \param[out] output_tape выходная лента;
+   * \param[in] value_count количество значений на входной ленте, если оно известно.
+   * \return статистика сортировки по виртуальным часам лент.
    */
-  void Sort(Tape<Value> &input_tape, Tape<Value> &output_tape) const;
+  SortStatistics Sort(
+      Tape<Value> &input_tape,
+      Tape<Value> &output_tape,
+      std::optional<size_t> value_count = std::nullopt
+  ) const;
 
  private:
   using TapeSharedPtr = std::shared_ptr<Tape<Value>>;
   using TapeUniquePtr = std::unique_ptr<Tape<Value>>;
+  using Duration = std::chrono::microseconds;
+
+  /// Отсортированная серия на временной ленте.
+  struct Run {
+    TapeSharedPtr tape;
+    /// Момент готовности серии на критическом пути.
+    Duration ready{0};
+    /// Количество значений серии.
+    size_t size = 0;
+    /// Первое и последнее значения непустой серии, то есть границы ее диапазона значений.
+    Value min{};
+    Value max{};
+  };
+
+  /// Деление памяти выбора с замещением.
+  struct HeapLayout {
+    /// Количество значений буфера чтения входа и буфера записи серии.
+    size_t io_block_size = 0;
+    /// Количество значений памяти слияний, освобождающих буферы временных лент.
+    size_t merge_size = 0;
+    /// Количество значений кучи, 0 - если память не вмещает даже буферы.
+    size_t heap_capacity = 0;
+  };
+
+  /// Буфер блока или слияния из пула вместе с резервом памяти под него.
+  struct Lease {
+    core::MemoryGovernor::Reservation reservation;
+    typename core::BufferPool<Value>::Buffer buffer;
+
+    /**
+     * \brief Вернуть буфер в пул и освободить резерв.
+     */
+    void Release() {
+      buffer = {};
+      reservation.Release();
+    }
+  };
 
   class ParallelSortContext {
    public:
+    /// Бюджет памяти, из которого резервируется место под каждый буфер блока, слияния или вывода:
+    /// резервы ограничивают количество одновременно обрабатываемых блоков, чтобы суммарно они не
+    /// превышали лимит памяти. Объявлен до пула потоков, так как резервы освобождаются в его
+    /// задачах.
+    core::MemoryGovernor memory;
+    /// Количество существующих временных лент, буферы которых зарезервированы в бюджете памяти.
+    std::atomic_size_t temp_tape_count = 0;
+    /// Буферы блоков и слияний по values_per_thread * block_buffer_count_ значений, которые
+    /// переиспользуются, а не выделяются заново. Свободные буферы пула не учитываются в бюджете
+    /// памяти, поэтому этапы, занимающие весь бюджет, сначала освобождают их.
+    core::BufferPool<Value> buffers;
+    /// Потоки отложенной записи и упреждающего чтения слияний, по одному на каждое слияние, которое
+    /// может выполняться одновременно. Объявлены до пула потоков, так как используются в его
+    /// задачах.
+    core::IoExecutor io_executor;
     ThreadPool thread_pool;
     /// Количество оставшихся блоков, после завершения запущенных слияний.
     std::atomic_size_t block_count;
     /// Количество значений, которые может обрабатывать один поток.
     std::atomic_size_t values_per_thread;
+    /// Количество потоков пула, занятых сортировкой блоков или слиянием.
+    std::atomic_size_t busy_threads = 0;
+    /// Количество потоков пула.
+    const size_t thread_count;
+    /// Максимальное количество серий, сливаемых одновременно.
+    const size_t merging_group_size;
+    /// Объем памяти в байтах, который могут занимать буферы временных лент при формировании серий
+    /// блоками: все, что не нужно буферам потоков, но не меньше отведенного лентам в конструкторе.
+    const size_t temp_tapes_memory_limit;
+    /// Момент готовности результата на критическом пути, если единственная серия была сразу
+    /// записана на выходную ленту при формировании серий.
+    std::optional<Duration> output_ready;
+    /// Серия, записанная на выходную ленту при формировании серий, курсор которой остается в ее
+    /// конце. Лента может быть длиннее серии, поэтому серия не участвует в промежуточных слияниях и
+    /// не учитывается в block_count, а перед последним слиянием на временную ленту переносится
+    /// только ее конец, пересекающийся с остальными сериями.
+    std::optional<Run> output_run;
 
-    explicit ParallelSortContext(const TapeSorter &sorter);
+    ParallelSortContext(const TapeSorter &sorter, const SortPlan &plan);
 
     /**
-     * \brief Добавить отсортированный блок.
+     * \brief Учесть серию, которая будет добавлена позже, и ее длину.
+     */
+    void Expect(size_t size);
+    /**
+     * \brief Добавить ожидаемую отсортированную серию.
      */
-    void Push(TapeSharedPtr tape);
+    void Push(Run run);
     /**
-     * \brief Удалить первый блок.
+     * \brief Удалить самую короткую серию.
      */
-    TapeSharedPtr Pop();
+    Run Pop();
     /**
-     * \brief Удалить заданное количество первых блоков для их слияния.
+     * \brief Удалить серии очередного слияния по плану Хаффмана.
+     *
+     * Сливаются самые короткие из всех оставшихся серий, включая еще не готовые, поэтому каждое
+     * значение перечитывается минимальное число раз. Чтобы все слияния кроме первого были полными,
+     * первое сливает столько серий, сколько останется после дополнения фиктивными пустыми сериями
+     * до полного дерева. Если среди самых коротких есть еще не готовые серии, слияние ждет их, а
+     * слияния независимых групп выполняются параллельно.
      */
-    std::vector<TapeSharedPtr> PopBlocksToMerge();
+    std::vector<Run> PopBlocksToMerge();
     [[nodiscard]] bool Empty() const;
+    /**
+     * \brief Учесть время работы лент.
+     */
+    void AddDeviceTime(Duration duration);
+    [[nodiscard]] Duration GetDeviceTime() const;
 
    private:
-    const size_t merging_group_size_;
-    /// Разделенные и отсортированные блоки данных.
-    std::queue<TapeSharedPtr> queue_;
+    /// Готовые серии, упорядоченные по длине.
+    std::multimap<size_t, Run> runs_;
+    /// Длины серий, которые сортируются или сливаются.
+    std::multiset<size_t> pending_sizes_;
+    /// Суммарное время работы лент.
+    Duration device_time_{0};
     std::condition_variable has_blocks_to_merge_;
     std::condition_variable has_blocks_;
     mutable std::mutex mutex_;
 
     /**
-     * \brief Проверка наличия нужного количества блоков для выполнения слияния.
+     * \brief Получить количество серий очередного слияния.
      */
-    [[nodiscard]] bool HasBlocksToMerge() const;
+    [[nodiscard]] size_t GetMergeGroupSize() const;
     /**
-     * \brief Незащищенное удаление блока.
+     * \brief Проверка, что самые короткие серии очередного слияния готовы.
      */
-    TapeSharedPtr Pop_();
+    [[nodiscard]] bool HasBlocksToMerge(size_t group_size) const;
+    /**
+     * \brief Незащищенное удаление самой короткой серии.
+     */
+    Run Pop_();
   };
 
+  /// Минимальное количество значений блока на один поток при параллельной сортировке блока.
+  static constexpr size_t kMinParallelSortPartSize = 16384;
+  /// Максимальное количество значений, которые сортируются сетями AVX2, а не поразрядно: на
+  /// больших массивах слияние 8-элементными регистрами медленнее поразрядной сортировки.
+  static constexpr size_t kMaxAvx2SortSize = 2048;
+  /// Количество побед подряд одной серии при слиянии, после которого ее значения копируются
+  /// блоками (galloping, как в TimSort).
+  static constexpr size_t kMinGallopWins = 7;
+  /// Доля серии на выходной ленте, в которой ищется конец, пересекающийся с остальными сериями:
+  /// каждое значение при поиске читается с конца ленты, поэтому дальше дешевле перенести серию
+  /// целиком.
+  static constexpr size_t kOutputRunScanDivisor = 4;
+
+  /// Параллельная сортировка блока, размер вспомогательных данных которой не зависит от
+  /// последовательной сортировки частей.
+  using BlockSampleSorter = ParallelSampleSorter<
+      Value,
+      Comparator,
+      ThreadPool,
+      std::function<void(std::span<Value>, std::span<Value>)>>;
+
+  /// Количество буферов по values_per_thread значений, необходимых для сортировки блока:
+  /// поразрядной и параллельной сортировкам нужен вспомогательный буфер того же размера.
+  size_t block_buffer_count_;
   /// Количество потоков, которое будет задействовано при сортировке.
   size_t thread_count_;
   /// Максимальное количество элементов, которое может содержаться в памяти с учетом ограничений.
@@ -118,35 +297,282 @@ class TapeSorter {
   size_t values_per_thread_;
   /// Провайдер временных лент для хранения промежуточных данных.
   const std::shared_ptr<TempTapeProvider<Value>> tape_provider_;
+  /// Объем памяти в байтах, который каждая временная лента занимает своими буферами.
+  size_t temp_tape_buffer_size_;
+  /// Берутся ли временные ленты без буферов, так как их буферы не вмещает лимит памяти.
+  bool unbuffered_temp_tapes_ = false;
+  /// Часть лимита памяти в байтах, отведенная буферам временных лент. Если ее не хватает на ленты
+  /// новой серии и результата слияния, серии сливаются, не дожидаясь конца входа.
+  size_t temp_tapes_memory_limit_;
+  /// Объем памяти в байтах, резервируемый вместе с каждым буфером блока или слияния под дерево
+  /// проигравших, состояние чтения серий или разбиение параллельной сортировки.
+  size_t lease_overhead_;
   Comparator comparator_;
-  /// Максимальное количество блоков, сливаемых одновременно.
-  const size_t merging_group_size_;
+  /// Максимальное количество блоков, сливаемых одновременно. Меньше заданного в конфигурации, если
+  /// служебные данные такого слияния не вмещает лимит памяти.
+  size_t merging_group_size_;
+  /// Способ формирования начальных серий.
+  RunFormationMode run_formation_mode_;
+  /// Размещать ли буферы блоков на больших страницах.
+  const bool huge_page_buffers_;
+  /// Ограничения конфигурации, в которых модель стоимости выбирает план.
+  SortLimits limits_;
+  /// Модель стоимости, если включена автоматическая настройка.
+  std::optional<SortCostModel> cost_model_;
 
+  /**
+   * \brief Получить план сортировки заданного количества значений.
+   *
+   * \return план, выбранный моделью стоимости, если включена автоматическая настройка и
+   * количество значений известно, иначе план по ограничениям конфигурации без предсказания.
+   */
+  SortPlan GetPlan(std::optional<size_t> value_count) const;
+
+  /**
+   * \brief Зарезервировать память и взять буфер из пула, дождавшись их освобождения.
+   */
+  std::shared_ptr<Lease> LeaseBuffer(ParallelSortContext &context) const;
+
+  /**
+   * \brief Получить объем вспомогательной памяти в байтах, которую занимает слияние заданного
+   * количества серий в @link MergeTapes @endlink, кроме его буферов.
+   */
+  static size_t GetMergeMemoryUsage(size_t run_count);
+
+  /**
+   * \brief Зарезервировать всю память, кроме буферов существующих временных лент, дождавшись
+   * завершения остальных задач.
+   */
+  core::MemoryGovernor::Reservation ReserveRest(ParallelSortContext &context) const;
+  /**
+   * \brief Получить временную ленту, дождавшись резерва памяти под ее буферы.
+   *
+   * Резерв освобождается вместе с лентой.
+   */
+  TapeSharedPtr GetTempTape(ParallelSortContext &context) const;
+  /**
+   * \brief Сливать самые короткие готовые серии, пока буферы временных лент не оставят места под
+   * ленты новой серии и результата слияния.
+   *
+   * Вызывается при формировании серий перед получением ленты новой серии, поэтому количество
+   * одновременно открытых временных лент ограничено независимо от размера входа.
+   *
+   * \param context контекст выполнения сортировки;
+   * \param tapes_memory_limit объем памяти в байтах, который могут занимать буферы лент;
+   * \param memory память буферов слияния, если пусто - она берется из пула.
+   */
+  void MergeToFreeTapeMemory(
+      ParallelSortContext &context, size_t tapes_memory_limit, std::span<Value> memory = {}
+  ) const;
+
+  /**
+   * \brief Разделить память выбора с замещением между буферами и кучей.
+   *
+   * \param memory_size объем отведенной памяти в байтах;
+   * \param merging_group_size количество серий, сливаемых одновременно.
+   */
+  HeapLayout GetHeapLayout(size_t memory_size, size_t merging_group_size) const;
+
+  /**
+   * \brief Разбить входные данные на блоки фиксированного размера и отсортировать каждый из них.
+   *
+   * Сортировка и запись блоков выполняются параллельно, результат сохраняется в контексте.
+   *
+   * Если вход умещается в один блок, он сортируется всеми потоками и сразу записывается на выходную
+   * ленту.
+   *
+   * \param input_tape входная лента;
+   * \param output_tape выходная лента;
+   * \param context контекст выполнения сортировки.
+   */
+  void FormFixedRuns(
+      Tape<Value> &input_tape, const TapeSharedPtr &output_tape, ParallelSortContext &context
+  ) const;
+  /**
+   * \brief Сформировать серии методом выбора с замещением.
+   *
+   * В памяти поддерживается куча текущей серии, элементы которые не могут продолжить текущую
+   * серию, откладываются в конец того же буфера и образуют следующую серию. На случайных данных
+   * серии получаются в среднем вдвое длиннее буфера, а на почти отсортированных - еще длиннее.
+   * Если вход целиком умещается в кучу, единственная серия сразу записывается на выходную ленту.
+   *
+   * \param input_tape входная лента;
+   * \param output_tape выходная лента;
+   * \param context контекст выполнения сортировки.
+   */
+  void FormReplacementSelectionRuns(
+      Tape<Value> &input_tape, const TapeSharedPtr &output_tape, ParallelSortContext &context
+  ) const;
+  /**
+   * \brief Сформировать естественные серии из уже упорядоченных участков входа.
+   *
+   * Убывающие блоки разворачиваются, а упорядоченные участки блоков дописываются к открытой серии,
+   * пока они ее продолжают, поэтому серии не ограничены размером блока. Неупорядоченные остатки
+   * блоков сортируются параллельно, как в @link FormFixedRuns @endlink. Первая серия пишется сразу
+   * на выходную ленту: если вход уже отсортирован, она оказывается единственной и сортировка
+   * сводится к одному копированию, а иначе ее начало обычно остается на месте при последнем
+   * слиянии (см. @link ReleaseOutputTape @endlink).
+   *
+   * \param input_tape входная лента;
+   * \param output_tape выходная лента;
+   * \param context контекст выполнения сортировки.
+   */
+  void FormNaturalRuns(
+      Tape<Value> &input_tape, const TapeSharedPtr &output_tape, ParallelSortContext &context
+  ) const;
+  /**
+   * \brief Отсортировать единственный блок входа всеми потоками и записать его на выходную ленту.
+   *
+   * \param context контекст выполнения сортировки;
+   * \param block_values значения блока;
+   * \param scratch вспомогательный буфер сортировки;
+   * \param read момент, когда блок был прочитан с входной ленты;
+   * \param output_tape выходная лента.
+   */
+  void SortAndWriteOutput(
+      ParallelSortContext &context,
+      std::span<Value> block_values,
+      std::span<Value> scratch,
+      Duration read,
+      const TapeSharedPtr &output_tape
+  ) const;
   /**
    * \brief Выполнить сортировку и запись блока на временную ленту.
    *
    * Результирующая лента сохраняется в переданном контексте.
    *
    * \param context контекст выполнения сортировки;
-   * \param block_values значения блока;
+   * \param tape временная лента блока;
+   * \param block_values значения блока, память которых освобождается до возврата;
+   * \param read момент, когда блок был прочитан с входной ленты.
    */
-  void SortAndWriteBlock(ParallelSortContext &context, std::vector<Value> &&block_values) const;
+  void SortAndWriteBlock(
+      ParallelSortContext &context,
+      TapeSharedPtr tape,
+      std::span<Value> block_values,
+      std::span<Value> scratch,
+      Duration read
+  ) const;
+  /**
+   * \brief Отсортировать значения блока в памяти.
+   *
+   * Если часть потоков пула простаивает (например, блоков меньше, чем потоков), блок сортируется
+   * параллельно @link ParallelSampleSorter @endlink вместе со свободными потоками.
+   */
+  void SortBlock(
+      ParallelSortContext &context, std::span<Value> block_values, std::span<Value> scratch
+  ) const;
+  /**
+   * \brief Отсортировать значения в одном потоке.
+   *
+   * Числа, сортируемые стандартными компараторами, сортируются поразрядно, а 32-битные при
+   * поддержке AVX-512 - векторно: так быстрее на блоках любого размера. С AVX2 векторно
+   * сортируются только массивы до @link kMaxAvx2SortSize @endlink значений, например части
+   * параллельной сортировки небольших блоков. Остальные значения сортируются std::sort.
+   *
+   * \param values сортируемые значения;
+   * \param scratch вспомогательный буфер того же размера, если он требуется.
+   */
+  void SortValues(std::span<Value> values, std::span<Value> scratch) const;
   /**
    * \brief Выполнить слияние нескольких отсортированных частей массива, записанных на ленты.
    *
-   * Результат слияния сохраняется в переданном контексте.
+   * Серии, диапазон значений которых не пересекается с другими, копируются блоками без дерева
+   * проигравших. В группах пересекающихся серий блоками копируются начало первой серии до начала
+   * второй и остаток последней оставшейся серии, а сливается только общий диапазон.
+   *
+   * \param context контекст выполнения сортировки;
+   * \param runs сливаемые части массива;
+   * \param memory память буферов слияния;
+   * \param target лента, на которую с текущей позиции записывается и затем перематывается
+   * результат;
+   * \param target_ready момент готовности целевой ленты на критическом пути.
+   * \return момент готовности результата на критическом пути.
+   */
+  Duration MergeTapes(
+      ParallelSortContext &context,
+      const std::vector<Run> &runs,
+      std::span<Value> memory,
+      const TapeSharedPtr &target,
+      Duration target_ready = Duration{0}
+  ) const;
+  /**
+   * \brief Выполнить последнее слияние всеми потоками пула с помощью @link ParallelMerger @endlink.
+   *
+   * Вызывается, когда сливаются все оставшиеся серии и других задач нет, поэтому слиянию
+   * отводится вся доступная память.
    *
    * \param context контекст выполнения сортировки;
-   * \param tapes сливаемые части массива.
+   * \param runs сливаемые серии;
+   * \param target лента, на которую с текущей позиции записывается и затем перематывается
+   * результат;
+   * \param target_ready момент готовности целевой ленты на критическом пути.
+   * \return момент готовности результата на критическом пути.
+   */
+  Duration MergeTapesInParallel(
+      ParallelSortContext &context,
+      const std::vector<Run> &runs,
+      const TapeSharedPtr &target,
+      Duration target_ready
+  ) const;
+  /**
+   * \brief Найти экспоненциальным поиском количество первых значений, предшествующих limit.
+   *
+   * Поиск проверяет позиции 1, 2, 4, ... и затем делит пополам последний интервал, поэтому
+   * требует O(log n) сравнений, где n - найденное количество, а не размер values.
+   *
+   * \param values отсортированные значения;
+   * \param limit граница;
+   * \param include_equal учитывать ли значения, равные границе.
    */
-  void MergeTapes(ParallelSortContext &context, const std::vector<TapeSharedPtr> &tapes) const;
+  size_t CountPreceding(
+      std::span<const Value> values, const Value &limit, bool include_equal
+  ) const;
+  /**
+   * \brief Разбить серии на группы, диапазоны значений которых попарно не пересекаются.
+   *
+   * \param runs серии;
+   * \return номера непустых серий каждой группы, упорядоченные по началу диапазона; группы
+   * упорядочены так же.
+   */
+  std::vector<std::vector<size_t>> GroupOverlappingRuns(const std::vector<Run> &runs) const;
+  /**
+   * \brief Получить длину и диапазон значений серии, которая получится слиянием заданных.
+   */
+  Run DescribeMergedRun(const std::vector<Run> &runs) const;
   /**
    * \brief Записать оставшиеся элементы с одного устройства на другое.
+   *
+   * Следующий блок читается с источника, пока записывается текущий.
+   *
    * \param[in] src источник элементов;
-   * \param[in] block_size размер блока, переносимого за раз;
-   * \param[out] target целевое устройство, куда будут записаны элементы.
+   * \param[in] block_size суммарный размер буферов чтения, не меньше 1;
+   * \param[out] target целевое устройство, куда будут записаны элементы;
+   * \param io_executor потоки упреждающего чтения источника.
+   */
+  void WriteLeftPart(
+      const TapeSharedPtr &src,
+      size_t block_size,
+      Tape<Value> &target,
+      core::IoExecutor &io_executor
+  ) const;
+  /**
+   * \brief Подготовить выходную ленту к последнему слиянию, в котором участвует хранимая на ней
+   * серия.
+   *
+   * Начало серии, не превосходящее начала остальных серий, уже находится на своем месте в
+   * результате, поэтому остается на ленте, а слияние пишется сразу за ним. На временную ленту
+   * переносится только конец серии, который пересекается с остальными: он ищется чтением с конца
+   * серии, а если оказывается слишком длинным, переносится вся серия.
+   *
+   * \param context контекст выполнения сортировки;
+   * \param runs остальные серии последнего слияния, к которым добавляется перенесенная часть;
+   * \param output_tape выходная лента.
+   * \return момент готовности выходной ленты к слиянию на критическом пути.
    */
-  void WriteLeftPart(Tape<Value> &src, size_t block_size, Tape<Value> &target) const;
+  Duration ReleaseOutputTape(
+      ParallelSortContext &context, std::vector<Run> &runs, const TapeSharedPtr &output_tape
+  ) const;
 };
 
 template <typename Value, typename Comparator, typename ThreadPool>
@@ -164,181 +590,1095 @@ TapeSorter<Value, Comparator, ThreadPool>::TapeSorter(
       ),
       tape_provider_(std::move(tape_provider)),
       comparator_(comparator),
-      merging_group_size_(config.GetProperty(kMaxMerginGroupSizeKey, kDefaultMaxMergingGroupSize)) {
+      merging_group_size_(config.GetProperty(kMaxMerginGroupSizeKey, kDefaultMaxMergingGroupSize)),
+      huge_page_buffers_(config.GetProperty(kHugePageBuffersKey, kDefaultHugePageBuffers) != 0) {
   if (values_in_memory_limit_ < 4) {
     throw std::invalid_argument(
         std::format("Increase memory limit! Minimum - {} bytes.", sizeof(Value) * 4)
     );
   }
 
+  if (merging_group_size_ < 2) {
+    throw std::invalid_argument("Merging group size must be at least 2.");
+  }
+
   const auto max_value_count_per_thread =
       config.GetProperty(kMaxValueCountPerThreadKey, kDefaultMaxValueCountPerThread);
-  values_per_thread_ = std::min(max_value_count_per_thread, values_in_memory_limit_);
+  const auto max_thread_count = config.GetProperty(kMaxThreadCountKey, kDefaultMaxThreadCount);
 
+  const auto memory_limit = values_in_memory_limit_ * sizeof(Value);
+  const auto max_part_count =
+      std::min(max_thread_count, max_value_count_per_thread / kMinParallelSortPartSize);
+  // параллельной сортировке вспомогательный буфер нужен, только если блок делится хотя бы на две
+  // части, иначе он лишь вдвое укоротил бы блоки
+  block_buffer_count_ = RadixSorter<Value, Comparator>::kApplicable || max_part_count > 1 ? 2 : 1;
+  const auto divide_memory = [&]() {
+    // буферам временных лент отводится место хотя бы под слияние двух серий, а по возможности
+    // под полное слияние, но не больше половины памяти
+    temp_tapes_memory_limit_ = std::max(
+        3 * temp_tape_buffer_size_,
+        std::min((merging_group_size_ + 2) * temp_tape_buffer_size_, memory_limit / 2)
+    );
+    lease_overhead_ = std::max(
+        GetMergeMemoryUsage(merging_group_size_), BlockSampleSorter::GetMemoryUsage(max_part_count)
+    );
+  };
+  // память под слияние merging_group_size_ блоков в одном потоке
+  const auto get_min_memory = [&]() {
+    return (merging_group_size_ + 1) * block_buffer_count_ * sizeof(Value) +
+           temp_tapes_memory_limit_ + lease_overhead_;
+  };
+  temp_tape_buffer_size_ = tape_provider_->GetBufferSize();
+  divide_memory();
+  if (get_min_memory() > memory_limit && temp_tape_buffer_size_ > 0) {
+    // буферы временных лент не помещаются в лимит, поэтому ленты обращаются к устройству напрямую
+    unbuffered_temp_tapes_ = true;
+    temp_tape_buffer_size_ = 0;
+    divide_memory();
+  }
+  while (get_min_memory() > memory_limit && merging_group_size_ > 2) {
+    // служебные данные слияния растут с количеством серий, поэтому в малой памяти их сливается
+    // меньше за раз
+    --merging_group_size_;
+    divide_memory();
+  }
+  size_t leases_memory = 0;
+  size_t block_values = 0;
+  // остальное делится между буферами блоков и слияний
+  const auto divide_leases = [&]() {
+    leases_memory = memory_limit - std::min(memory_limit, temp_tapes_memory_limit_);
+    block_values = (leases_memory - std::min(leases_memory, lease_overhead_)) / sizeof(Value);
+    values_per_thread_ = std::min(max_value_count_per_thread, block_values / block_buffer_count_);
+  };
+  divide_leases();
+  const auto auto_tune = config.GetProperty(kAutoTuneKey, kDefaultAutoTune) != 0;
+  if (auto_tune && values_per_thread_ / (merging_group_size_ + 1) < 1 && values_per_thread_ > 2) {
+    // при автонастройке размер группы лишь ограничивает выбор модели стоимости, которая и так
+    // сливает не больше values_per_thread_ - 1 серий за раз
+    merging_group_size_ = values_per_thread_ - 1;
+    divide_memory();
+    divide_leases();
+  }
   if (values_per_thread_ / (merging_group_size_ + 1) < 1) {
+    if (values_per_thread_ == max_value_count_per_thread) {
+      throw std::invalid_argument(std::format(
+          "Can't merge {} blocks of {} values in thread! Increase max value count per thread or "
+          "decrease max merging group size.",
+          merging_group_size_,
+          values_per_thread_
+      ));
+    }
     throw std::invalid_argument(std::format(
         "Can't merge {} blocks in thread! Increase memory limit or max value count per thread - "
         "need minimum {} bytes.",
         merging_group_size_,
-        (merging_group_size_ + 1) * sizeof(Value)
+        get_min_memory()
     ));
   }
 
-  const auto max_thread_count = config.GetProperty(kMaxThreadCountKey, kDefaultMaxThreadCount);
-  thread_count_ = std::min(max_thread_count, values_in_memory_limit_ / values_per_thread_);
+  thread_count_ = std::min(
+      max_thread_count,
+      leases_memory / (values_per_thread_ * block_buffer_count_ * sizeof(Value) + lease_overhead_)
+  );
+
+  const auto run_formation_mode = config.GetProperty(
+      kRunFormationModeKey, static_cast<std::uint64_t>(kDefaultRunFormationMode)
+  );
+  if (run_formation_mode > static_cast<std::uint64_t>(RunFormationMode::kNaturalRuns)) {
+    throw std::invalid_argument(std::format("Unknown run formation mode: {}.", run_formation_mode));
+  }
+  run_formation_mode_ = static_cast<RunFormationMode>(run_formation_mode);
+
+  limits_ = {
+      .values_in_memory = block_values,
+      .buffer_count = block_buffer_count_,
+      .max_values_per_thread = values_per_thread_,
+      .max_thread_count = max_thread_count,
+      .max_merging_group_size = merging_group_size_,
+  };
+  if (run_formation_mode_ == RunFormationMode::kReplacementSelection) {
+    // на случайном входе серии в среднем вдвое длиннее кучи
+    const auto heap_layout =
+        GetHeapLayout(memory_limit - temp_tapes_memory_limit_, merging_group_size_);
+    limits_.initial_run_size = 2 * heap_layout.heap_capacity;
+  }
+  if (auto_tune) {
+    cost_model_.emplace(config);
+  }
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
-void TapeSorter<Value, Comparator, ThreadPool>::Sort(
-    Tape<Value> &input_tape, Tape<Value> &output_tape
+SortStatistics TapeSorter<Value, Comparator, ThreadPool>::Sort(
+    Tape<Value> &input_tape, Tape<Value> &output_tape, const std::optional<size_t> value_count
 ) const {
-  ParallelSortContext context(*this);
-  // прочитать входные данные поблочно, ввиду ограничения использования памяти
-  auto temp_tape_values = input_tape.ReadN(context.values_per_thread);  // элементы очередного блока
-  while (!temp_tape_values.empty()) {
-    ++context.block_count;
-    context.thread_pool.PostTask([this, block_values = std::move(temp_tape_values), &context](
-                                 ) mutable {
-      SortAndWriteBlock(context, std::move(block_values));
-    });
-    temp_tape_values =
-        input_tape.ReadN(context.values_per_thread);  // прочитать следующий блок данных
+  const auto input_start = input_tape.GetElapsedTime();
+  const auto output_start = output_tape.GetElapsedTime();
+  const auto plan = GetPlan(value_count);
+  ParallelSortContext context(*this, plan);
+  // невладеющий указатель, чтобы писать результат на выходную ленту так же, как на временные
+  const TapeSharedPtr output(&output_tape, [](Tape<Value> *) {});
+  switch (run_formation_mode_) {
+    case RunFormationMode::kReplacementSelection:
+      FormReplacementSelectionRuns(input_tape, output, context);
+      break;
+    case RunFormationMode::kNaturalRuns:
+      FormNaturalRuns(input_tape, output, context);
+      break;
+    default:
+      FormFixedRuns(input_tape, output, context);
   }
+  const auto input_time = input_tape.GetElapsedTime() - input_start;
+  context.AddDeviceTime(input_time);
+  SortStatistics statistics;
+  statistics.critical_path = context.output_ready.value_or(input_time);
   // выполнить попарное слияние блоков данных, пока не останется 1 блок
-  while (context.block_count > 1) {
-    std::vector<TapeSharedPtr> blocks_to_merge = context.PopBlocksToMerge();
+  while (context.block_count + (context.output_run ? 1 : 0) > 1) {
+    const auto last =
+        context.block_count + (context.output_run ? 1 : 0) <= context.merging_group_size;
+    std::vector<Run> blocks_to_merge = context.PopBlocksToMerge();
     const size_t merged = blocks_to_merge.size();
-    context.thread_pool.PostTask([this, tapes = std::move(blocks_to_merge), &context]() mutable {
-      MergeTapes(context, tapes);
-    });
-    context.block_count.fetch_sub(merged - 1);
+    if (last) {
+      // последнее слияние записывает результат сразу на выходную ленту
+      Duration output_ready{0};
+      if (context.output_run) {
+        output_ready = ReleaseOutputTape(context, blocks_to_merge, output);
+      }
+      // серии с непересекающимися диапазонами только копируются, поэтому потоки им не помогут
+      const auto overlapping =
+          GroupOverlappingRuns(blocks_to_merge).size() < blocks_to_merge.size();
+      if (context.thread_count > 1 && overlapping) {
+        // остальные потоки простаивают, поэтому оно распараллеливается
+        statistics.critical_path =
+            MergeTapesInParallel(context, blocks_to_merge, output, output_ready);
+      } else {
+        const auto lease = LeaseBuffer(context);
+        statistics.critical_path =
+            MergeTapes(context, blocks_to_merge, lease->buffer.Get(), output, output_ready);
+      }
+      context.block_count = 0;
+      break;
+    }
+    auto merged_run = DescribeMergedRun(blocks_to_merge);
+    context.block_count.fetch_sub(merged);
+    context.Expect(merged_run.size);
+    // ожидание происходит в этом потоке, поэтому потоки пула никогда не блокируются
+    const auto lease = LeaseBuffer(context);
+    merged_run.tape = GetTempTape(context);  // устройство для объединенных данных
+    context.thread_pool.PostTask(
+        [this, runs = std::move(blocks_to_merge), merged_run, lease, &context]() {
+          ++context.busy_threads;
+          Run run = merged_run;
+          run.ready = MergeTapes(context, runs, lease->buffer.Get(), run.tape);
+          context.Push(std::move(run));
+          --context.busy_threads;
+          lease->Release();
+        }
+    );
   }
+  // единственная серия, которую не удалось сразу записать на выходную ленту, переносится на нее
   if (context.block_count > 0) {
     const auto sorted = context.Pop();
-    WriteLeftPart(*sorted, values_in_memory_limit_, output_tape);
+    // других задач уже нет, поэтому переносу отводится вся память, кроме буфера ленты серии
+    auto reservation = ReserveRest(context);
+    context.buffers.Trim();
+    const auto sorted_start = sorted.tape->GetElapsedTime();
+    WriteLeftPart(
+        sorted.tape,
+        std::max<size_t>(1, reservation.GetSize() / sizeof(Value)),
+        output_tape,
+        context.io_executor
+    );
     output_tape.MoveToBegin();
+    reservation.Release();
+    const auto output_time = output_tape.GetElapsedTime() - output_start;
+    const auto write_time = sorted.tape->GetElapsedTime() - sorted_start + output_time;
+    context.AddDeviceTime(write_time);
+    statistics.critical_path = sorted.ready + write_time;
+  }
+  statistics.device_time = context.GetDeviceTime();
+  statistics.peak_buffer_memory =
+      context.buffers.GetPeakAllocatedCount() * context.buffers.GetCapacity() * sizeof(Value);
+  if (cost_model_ && value_count) {
+    statistics.plan = plan;
+  }
+  return statistics;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+SortPlan TapeSorter<Value, Comparator, ThreadPool>::GetPlan(
+    const std::optional<size_t> value_count
+) const {
+  if (cost_model_ && value_count) {
+    return cost_model_->Choose(*value_count, limits_);
+  }
+  return {values_per_thread_, thread_count_, merging_group_size_};
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::FormFixedRuns(
+    Tape<Value> &input_tape, const TapeSharedPtr &output_tape, ParallelSortContext &context
+) const {
+  const auto input_start = input_tape.GetElapsedTime();
+  // прочитать входные данные поблочно, ввиду ограничения использования памяти: следующий блок
+  // читается, только когда освободится буфер одного из уже записанных блоков
+  while (true) {
+    MergeToFreeTapeMemory(context, context.temp_tapes_memory_limit);
+    // буфер вмещает и вспомогательный буфер сортировки блока
+    const auto lease = LeaseBuffer(context);
+    const auto buffer = lease->buffer.Get();
+    const auto size = input_tape.ReadInto(buffer.first(context.values_per_thread));
+    if (size == 0) {
+      break;
+    }
+    const auto read = input_tape.GetElapsedTime() - input_start;
+    const auto values = buffer.first(size);
+    const auto scratch =
+        buffer.subspan(context.values_per_thread).first(block_buffer_count_ > 1 ? size : 0);
+    if (context.block_count == 0 && size < context.values_per_thread) {
+      // вход закончился на первом блоке
+      SortAndWriteOutput(context, values, scratch, read, output_tape);
+      break;
+    }
+    context.Expect(size);
+    auto tape = GetTempTape(context);  // временное устройство для хранения блока
+    context.thread_pool.PostTask([this, lease, tape, values, scratch, read, &context]() {
+      ++context.busy_threads;
+      SortAndWriteBlock(context, tape, values, scratch, read);
+      --context.busy_threads;
+      lease->Release();
+    });
+  }
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::GetHeapLayout(
+    const size_t memory_size, const size_t merging_group_size
+) const -> HeapLayout {
+  const auto values_in_memory =
+      (memory_size - std::min(memory_size, lease_overhead_)) / sizeof(Value);
+  HeapLayout layout;
+  layout.io_block_size = std::max<size_t>(1, values_in_memory / 32);
+  if (temp_tape_buffer_size_ > 0) {
+    layout.merge_size = std::max(2 * layout.io_block_size, merging_group_size + 1);
+  }
+  const auto buffers_size = 2 * layout.io_block_size + layout.merge_size;
+  if (values_in_memory > buffers_size) {
+    layout.heap_capacity = values_in_memory - buffers_size;
+  }
+  return layout;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::FormReplacementSelectionRuns(
+    Tape<Value> &input_tape, const TapeSharedPtr &output_tape, ParallelSortContext &context
+) const {
+  // серии формируются до начала слияний, поэтому им отводится вся память, кроме буферов временных
+  // лент: буферы чтения и записи и слияния серий, которые не умещаются на ленты, занимают ее часть,
+  // остальное отводится под кучу
+  const auto reservation = context.memory.Reserve(
+      context.memory.GetLimit() - std::min(context.memory.GetLimit(), temp_tapes_memory_limit_)
+  );
+  context.buffers.Trim();
+  const auto layout = GetHeapLayout(reservation.GetSize(), context.merging_group_size);
+  if (layout.heap_capacity == 0) {
+    throw std::invalid_argument("Can't form runs by replacement selection! Increase memory limit.");
+  }
+  const auto io_block_size = layout.io_block_size;
+  const auto heap_capacity = layout.heap_capacity;
+  std::vector<Value> merge_memory(layout.merge_size);
+
+  std::vector<Value> input_block(io_block_size);
+  size_t input_size = 0;
+  size_t input_pos = 0;
+  // вход исчерпан, если прочитанный блок пройден, а следующий пуст
+  const auto input_exhausted = [&]() {
+    if (input_pos == input_size) {
+      input_size = input_tape.ReadInto(input_block);
+      input_pos = 0;
+    }
+    return input_size == 0;
+  };
+  const auto read_next = [&]() -> std::optional<Value> {
+    if (input_exhausted()) {
+      return std::nullopt;
+    }
+    return input_block[input_pos++];
+  };
+  // std::*_heap строят max-кучу, поэтому компаратор инвертируется
+  const auto heap_comparator = [this](const Value &f, const Value &s) {
+    return comparator_(s, f);
+  };
+
+  // вход и серии обрабатываются последовательно, поэтому время их работы складывается
+  const auto input_start = input_tape.GetElapsedTime();
+  Duration runs_time{0};
+
+  // [0, heap_size) - куча текущей серии, [heap_size, buffer.size()) - элементы следующей серии
+  std::vector<Value> buffer;
+  buffer.reserve(heap_capacity);
+  while (buffer.size() < heap_capacity) {
+    const auto value = read_next();
+    if (!value) {
+      break;
+    }
+    buffer.push_back(*value);
+  }
+  // вход целиком уместился в кучу, поэтому серия будет единственной. Куча может быть заполнена
+  // ровно всем входом, поэтому проверяется конец входа, а не ее размер
+  const auto single_run = input_exhausted();
+
+  while (!buffer.empty()) {
+    auto heap_size = buffer.size();
+    std::make_heap(buffer.begin(), buffer.end(), heap_comparator);
+    if (!single_run) {
+      MergeToFreeTapeMemory(context, temp_tapes_memory_limit_, merge_memory);
+    }
+    // устройство для очередной серии
+    TapeSharedPtr tape = single_run ? output_tape : GetTempTape(context);
+    const auto tape_start = tape->GetElapsedTime();
+    size_t run_size = 0;
+    Value run_min{};
+    Value run_max{};
+    {
+      TapeBlockWriter<Value> run(io_block_size, tape);
+      while (heap_size > 0) {
+        const auto heap_end = buffer.begin() + static_cast<std::ptrdiff_t>(heap_size);
+        std::pop_heap(buffer.begin(), heap_end, heap_comparator);
+        const auto min = buffer[heap_size - 1];
+        run.Write(min);
+        if (run_size++ == 0) {
+          run_min = min;
+        }
+        run_max = min;
+        const auto next = read_next();
+        if (!next) {
+          // вход исчерпан: освободившееся место занимает последний элемент следующей серии
+          buffer[heap_size - 1] = buffer.back();
+          buffer.pop_back();
+          --heap_size;
+        } else if (comparator_(*next, min)) {
+          // элемент меньше последнего записанного, поэтому он попадет только в следующую серию
+          buffer[heap_size - 1] = *next;
+          --heap_size;
+        } else {
+          buffer[heap_size - 1] = *next;
+          std::push_heap(buffer.begin(), heap_end, heap_comparator);
+        }
+      }
+      run.Flush();
+    }
+    tape->MoveToBegin();
+    const auto run_time = tape->GetElapsedTime() - tape_start;
+    runs_time += run_time;
+    context.AddDeviceTime(run_time);
+    const auto ready = input_tape.GetElapsedTime() - input_start + runs_time;
+    if (single_run) {
+      context.output_ready = ready;
+    } else {
+      context.Expect(run_size);
+      context.Push({std::move(tape), ready, run_size, run_min, run_max});
+    }
   }
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
 TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::ParallelSortContext(
-    const TapeSorter &sorter
+    const TapeSorter &sorter, const SortPlan &plan
 )
-    : thread_pool(sorter.thread_count_),
-      values_per_thread(sorter.values_per_thread_),
-      merging_group_size_(sorter.merging_group_size_) {
+    : memory(sorter.values_in_memory_limit_ * sizeof(Value)),
+      buffers(plan.values_per_thread * sorter.block_buffer_count_, sorter.huge_page_buffers_),
+      io_executor(plan.thread_count),
+      thread_pool(plan.thread_count),
+      values_per_thread(plan.values_per_thread),
+      thread_count(plan.thread_count),
+      merging_group_size(plan.merging_group_size),
+      temp_tapes_memory_limit(std::max(
+          sorter.temp_tapes_memory_limit_,
+          memory.GetLimit() -
+              std::min(
+                  memory.GetLimit(),
+                  thread_count * (buffers.GetCapacity() * sizeof(Value) + sorter.lease_overhead_)
+              )
+      )) {
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
-void TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::Push(TapeSharedPtr tape) {
+void TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::Expect(const size_t size) {
   std::lock_guard lock(mutex_);
-  queue_.emplace(std::move(tape));
-  if (HasBlocksToMerge()) {
-    has_blocks_to_merge_.notify_one();
+  ++block_count;
+  pending_sizes_.insert(size);
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::Push(Run run) {
+  std::lock_guard lock(mutex_);
+  if (const auto pending = pending_sizes_.find(run.size); pending != pending_sizes_.end()) {
+    pending_sizes_.erase(pending);
   }
+  const auto size = run.size;
+  runs_.emplace(size, std::move(run));
+  has_blocks_to_merge_.notify_one();
   has_blocks_.notify_one();
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
-typename TapeSorter<Value, Comparator, ThreadPool>::TapeSharedPtr
+typename TapeSorter<Value, Comparator, ThreadPool>::Run
 TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::Pop() {
   std::unique_lock lock(mutex_);
   has_blocks_.wait(lock, [this] {
-    return !queue_.empty();
+    return !runs_.empty();
   });
   return Pop_();
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
-std::vector<typename TapeSorter<Value, Comparator, ThreadPool>::TapeSharedPtr>
+std::vector<typename TapeSorter<Value, Comparator, ThreadPool>::Run>
 TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::PopBlocksToMerge() {
   std::unique_lock lock(mutex_);
-  has_blocks_to_merge_.wait(lock, [this] {
-    return HasBlocksToMerge();
+  const auto group_size = GetMergeGroupSize();
+  has_blocks_to_merge_.wait(lock, [this, group_size] {
+    return HasBlocksToMerge(group_size);
   });
-  std::vector<TapeSharedPtr> tapes(std::min(merging_group_size_, block_count.load()));
-  for (size_t i = 0; i < tapes.size(); ++i) {
-    tapes[i] = Pop_();
+  std::vector<Run> runs(group_size);
+  for (size_t i = 0; i < runs.size(); ++i) {
+    runs[i] = Pop_();
   }
-  return tapes;
+  return runs;
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
 bool TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::Empty() const {
   std::lock_guard lock(mutex_);
-  return queue_.empty();
+  return runs_.empty();
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::AddDeviceTime(
+    const Duration duration
+) {
+  std::lock_guard lock(mutex_);
+  device_time_ += duration;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::GetDeviceTime() const
+    -> Duration {
+  std::lock_guard lock(mutex_);
+  return device_time_;
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
-bool TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::HasBlocksToMerge() const {
-  return queue_.size() >= std::min(block_count.load(), merging_group_size_);
+size_t TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::GetMergeGroupSize() const {
+  // серия на выходной ленте участвует только в последнем слиянии
+  const auto run_count = block_count + (output_run ? 1 : 0);
+  if (run_count <= merging_group_size) {
+    return block_count;
+  }
+  // каждое слияние уменьшает количество серий на merging_group_size - 1
+  return (run_count - 2) % (merging_group_size - 1) + 2;
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
-typename TapeSorter<Value, Comparator, ThreadPool>::TapeSharedPtr
+bool TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::HasBlocksToMerge(
+    const size_t group_size
+) const {
+  if (runs_.size() < group_size) {
+    return false;
+  }
+  // не готовые серии не короче выбранных, иначе план требует дождаться их
+  const auto longest = std::next(runs_.begin(), static_cast<std::ptrdiff_t>(group_size) - 1);
+  return pending_sizes_.empty() || longest->first <= *pending_sizes_.begin();
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+typename TapeSorter<Value, Comparator, ThreadPool>::Run
 TapeSorter<Value, Comparator, ThreadPool>::ParallelSortContext::Pop_() {
-  TapeSharedPtr value = std::move(queue_.front());
-  queue_.pop();
+  Run value = std::move(runs_.begin()->second);
+  runs_.erase(runs_.begin());
   return value;
 }
 
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::FormNaturalRuns(
+    Tape<Value> &input_tape, const TapeSharedPtr &output_tape, ParallelSortContext &context
+) const {
+  /// Серия, которую могут продолжить следующие блоки.
+  struct OpenRun {
+    TapeSharedPtr tape;
+    Value first;
+    Value last;
+    size_t size = 0;
+  };
+
+  // открытая серия пишется этим же потоком между чтениями входа, поэтому время складывается
+  const auto input_start = input_tape.GetElapsedTime();
+  Duration runs_time{0};
+  const auto elapsed = [&]() {
+    return input_tape.GetElapsedTime() - input_start + runs_time;
+  };
+  std::optional<OpenRun> open;
+  const auto append = [&](std::span<const Value> values) {
+    const auto write_start = open->tape->GetElapsedTime();
+    open->tape->WriteFrom(values);
+    const auto write_time = open->tape->GetElapsedTime() - write_start;
+    runs_time += write_time;
+    context.AddDeviceTime(write_time);
+    open->last = values.back();
+    open->size += values.size();
+  };
+  const auto close = [&]() {
+    if (open->tape == output_tape) {
+      // лента не перематывается: начало серии может остаться на месте при последнем слиянии
+      context.output_run =
+          Run{std::move(open->tape), elapsed(), open->size, open->first, open->last};
+    } else {
+      const auto rewind_start = open->tape->GetElapsedTime();
+      open->tape->MoveToBegin();
+      const auto rewind_time = open->tape->GetElapsedTime() - rewind_start;
+      runs_time += rewind_time;
+      context.AddDeviceTime(rewind_time);
+      context.Expect(open->size);
+      context.Push({std::move(open->tape), elapsed(), open->size, open->first, open->last});
+    }
+    open.reset();
+  };
+  const auto descending = [this](const Value &f, const Value &s) {
+    return comparator_(s, f);
+  };
+
+  while (true) {
+    // каждая итерация заводит не больше одной временной ленты
+    MergeToFreeTapeMemory(context, context.temp_tapes_memory_limit);
+    const auto lease = LeaseBuffer(context);
+    const auto buffer = lease->buffer.Get();
+    const auto values =
+        buffer.first(input_tape.ReadInto(buffer.first(context.values_per_thread)));
+    if (values.empty()) {
+      break;
+    }
+    if (std::ranges::is_sorted(values, descending)) {
+      std::ranges::reverse(values);
+    }
+    // упорядоченный префикс блока дописывается к открытой серии, если продолжает ее
+    auto rest = values;
+    if (open && !comparator_(values.front(), open->last)) {
+      const auto sorted_end = std::ranges::is_sorted_until(values, comparator_);
+      const auto sorted_size = static_cast<size_t>(sorted_end - values.begin());
+      append(values.first(sorted_size));
+      rest = values.subspan(sorted_size);
+    }
+    if (rest.empty()) {
+      continue;
+    }
+    if (open) {
+      close();
+    }
+    if (std::ranges::is_sorted(rest, comparator_)) {
+      // первая серия может оказаться единственной, поэтому она пишется на выходную ленту
+      const auto first = context.block_count == 0 && !context.output_run;
+      open = OpenRun{first ? output_tape : GetTempTape(context), rest.front(), rest.back()};
+      append(rest);
+      continue;
+    }
+    const auto read = elapsed();
+    const auto scratch =
+        buffer.subspan(context.values_per_thread).first(block_buffer_count_ > 1 ? rest.size() : 0);
+    if (context.block_count == 0 && !context.output_run &&
+        values.size() < context.values_per_thread) {
+      // вход закончился на первом блоке
+      SortAndWriteOutput(context, rest, scratch, read, output_tape);
+      return;
+    }
+    context.Expect(rest.size());
+    auto tape = GetTempTape(context);
+    context.thread_pool.PostTask([this, lease, tape, rest, scratch, read, &context]() {
+      ++context.busy_threads;
+      SortAndWriteBlock(context, tape, rest, scratch, read);
+      --context.busy_threads;
+      lease->Release();
+    });
+  }
+  if (!open) {
+    return;
+  }
+  if (open->tape == output_tape) {
+    // других серий нет, поэтому вход уже полностью записан на выходную ленту
+    const auto rewind_start = output_tape->GetElapsedTime();
+    output_tape->MoveToBegin();
+    const auto rewind_time = output_tape->GetElapsedTime() - rewind_start;
+    context.AddDeviceTime(rewind_time);
+    context.output_ready = elapsed() + rewind_time;
+    return;
+  }
+  close();
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::SortAndWriteOutput(
+    ParallelSortContext &context,
+    std::span<Value> block_values,
+    std::span<Value> scratch,
+    const Duration read,
+    const TapeSharedPtr &output_tape
+) const {
+  SortBlock(context, block_values, scratch);
+  const auto output_start = output_tape->GetElapsedTime();
+  output_tape->WriteFrom(block_values);
+  output_tape->MoveToBegin();
+  const auto write_time = output_tape->GetElapsedTime() - output_start;
+  context.AddDeviceTime(write_time);
+  context.output_ready = read + write_time;
+}
+
 template <typename Value, typename Comparator, typename ThreadPool>
 void TapeSorter<Value, Comparator, ThreadPool>::SortAndWriteBlock(
-    ParallelSortContext &context, std::vector<Value> &&block_values
+    ParallelSortContext &context,
+    TapeSharedPtr tape,
+    std::span<Value> block_values,
+    std::span<Value> scratch,
+    const Duration read
 ) const {
-  auto tape = tape_provider_->Get();  // временное устройство для хранения очередного блока
-  std::sort(block_values.begin(), block_values.end(), comparator_);
-  tape->WriteN(block_values);
+  SortBlock(context, block_values, scratch);
+  const auto write_start = tape->GetElapsedTime();
+  tape->WriteFrom(block_values);
   tape->MoveToBegin();
-  context.Push(std::move(tape));
+  const auto write_time = tape->GetElapsedTime() - write_start;
+  context.AddDeviceTime(write_time);
+  context.Push(
+      {std::move(tape), read + write_time, block_values.size(), block_values.front(),
+       block_values.back()}
+  );
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::SortBlock(
+    ParallelSortContext &context, std::span<Value> block_values, std::span<Value> scratch
+) const {
+  // занятым считается и текущий поток
+  const auto idle_threads =
+      context.thread_count - std::min(context.thread_count, context.busy_threads.load());
+  auto part_count = std::min(idle_threads + 1, block_values.size() / kMinParallelSortPartSize);
+  if (scratch.size() < block_values.size()) {
+    // без вспомогательного буфера блок сортируется последовательно
+    part_count = 1;
+  }
+  if constexpr (!RadixSorter<Value, Comparator>::kApplicable) {
+    if (part_count < 2) {
+      SortValues(block_values, {});
+      return;
+    }
+  }
+  const auto sort = [this](std::span<Value> values, std::span<Value> values_scratch) {
+    SortValues(values, values_scratch);
+  };
+  ParallelSampleSorter<Value, Comparator, ThreadPool, decltype(sort)>(
+      context.thread_pool, comparator_, sort
+  )
+      .Sort(block_values, scratch, part_count);
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
-void TapeSorter<Value, Comparator, ThreadPool>::MergeTapes(
-    ParallelSortContext &context, const std::vector<TapeSharedPtr> &tapes
+void TapeSorter<Value, Comparator, ThreadPool>::SortValues(
+    std::span<Value> values, std::span<Value> scratch
 ) const {
-  using BlockReader = TapeBlockReader<Value>;
+  if constexpr (RadixSorter<Value, Comparator>::kApplicable) {
+    if constexpr (core::SimdSorter<Value, Comparator>::kApplicable) {
+      const auto isa = core::GetSupportedSimdIsa();
+      if (isa == core::SimdIsa::kAvx512 ||
+          (isa == core::SimdIsa::kAvx2 && values.size() <= kMaxAvx2SortSize)) {
+        core::SimdSorter<Value, Comparator>::Sort(values, scratch, isa);
+        return;
+      }
+    }
+    RadixSorter<Value, Comparator>::Sort(values, scratch);
+  } else {
+    std::sort(values.begin(), values.end(), comparator_);
+  }
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::MergeTapes(
+    ParallelSortContext &context,
+    const std::vector<Run> &runs,
+    std::span<Value> memory,
+    const TapeSharedPtr &target,
+    const Duration target_ready
+) const -> Duration {
   using BlockWriter = TapeBlockWriter<Value>;
 
-  // слияние будет выполняться по частям указанного размера
-  const auto block_size = context.values_per_thread / (tapes.size() + 1);
+  // слияние начинается, когда готовы все серии и целевая лента
+  auto start = target_ready;
+  std::vector<Duration> runs_start;
+  std::vector<TapeSharedPtr> tapes;
+  runs_start.reserve(runs.size());
+  tapes.reserve(runs.size());
+  for (const auto &run : runs) {
+    start = std::max(start, run.ready);
+    runs_start.push_back(run.tape->GetElapsedTime());
+    tapes.push_back(run.tape);
+  }
+
+  // слияние будет выполняться по частям указанного размера: при фоновом вводе-выводе память делится
+  // между буферами серий, запасными буферами для чтения по прогнозу и двумя буферами записи
+  const MergeBufferLayout layout(memory.size(), runs.size());
+  const auto write_buffer_size = layout.GetWriteBufferSize();
+
+  const auto target_start = target->GetElapsedTime();
+  const auto io_executor = layout.async_io ? &context.io_executor : nullptr;
+  BlockWriter merged_block(memory.first(write_buffer_size), target, io_executor);
+
+  ForecastingRunReader<Value, Comparator> readers(
+      std::move(tapes),
+      memory.subspan(write_buffer_size),
+      layout.block_size,
+      layout.GetSpareCount(),
+      io_executor,
+      comparator_
+  );
+  // скопировать значения серии блоками, пока они предшествуют limit
+  const auto copy = [&](const size_t run, const Value *limit, const bool include_equal) {
+    for (auto has_values = !readers.IsEnd(run); has_values;) {
+      const auto block = readers.ReadBlock(run);
+      const auto count = limit ? CountPreceding(block, *limit, include_equal) : block.size();
+      merged_block.WriteFrom(block.first(count));
+      has_values = readers.Skip(run, count) && count == block.size();
+    }
+  };
+
+  for (const auto &group : GroupOverlappingRuns(runs)) {
+    if (group.size() == 1) {
+      copy(group.front(), nullptr, false);
+      continue;
+    }
+    // значения первой серии меньше начала второй не пересекаются с другими сериями
+    copy(group[0], &runs[group[1]].min, false);
+    // дерево хранит только индексы серий группы и их текущие значения
+    LoserTree<Value, Comparator> sources(group.size(), comparator_);
+    size_t source_count = 0;
+    for (size_t i = 0; i < group.size(); ++i) {
+      if (!readers.IsEnd(group[i])) {
+        sources.Push(i, readers.Read(group[i]));
+        ++source_count;
+      }
+    }
+    sources.Build();
+
+    // количество побед подряд источника last_winner
+    size_t wins = 0;
+    size_t last_winner = group.size();
+    while (source_count > 1) {
+      const auto winner = sources.Top();
+      const auto run = group[winner];
+      wins = winner == last_winner ? wins + 1 : 1;
+      last_winner = winner;
+      bool has_values = true;
+      if (wins < kMinGallopWins) {
+        merged_block.Write(sources.TopValue());
+        has_values = readers.MoveForward(run);
+      } else {
+        // серия выигрывает подряд, поэтому ее значения до головы следующей серии копируются
+        // блоками: граница находится экспоненциальным поиском
+        copy(run, sources.SecondValue(), true);
+        has_values = !readers.IsEnd(run);
+        wins = 0;
+      }
+      if (has_values) {
+        sources.ReplaceTop(readers.Read(run));
+      } else {
+        sources.PopTop();
+        --source_count;
+      }
+    }
+    // остаток последней серии сливать не с чем
+    if (!sources.Empty()) {
+      copy(group[sources.Top()], nullptr, false);
+    }
+  }
+  merged_block.Flush();
+  target->MoveToBegin();
+
+  // без фоновых операций ленты обслуживаются одним потоком по очереди, а с ними серии читаются
+  // и результат записывается одновременно со слиянием, которое ограничено самой медленной лентой
+  const auto write_time = target->GetElapsedTime() - target_start;
+  auto merge_time = write_time;
+  auto critical_path = write_time;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    const auto read_time = runs[i].tape->GetElapsedTime() - runs_start[i];
+    merge_time += read_time;
+    critical_path = std::max(critical_path, read_time);
+  }
+  context.AddDeviceTime(merge_time);
+  return start + (layout.async_io ? critical_path : merge_time);
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::MergeTapesInParallel(
+    ParallelSortContext &context,
+    const std::vector<Run> &runs,
+    const TapeSharedPtr &target,
+    const Duration target_ready
+) const -> Duration {
+  // занять всю память, кроме буферов лент: она освобождается по мере завершения оставшихся задач
+  // пула
+  auto reservation = ReserveRest(context);
+  context.buffers.Trim();
+
+  auto start = target_ready;
+  Duration runs_start = target->GetElapsedTime();
+  std::vector<TapeSharedPtr> sources;
+  sources.reserve(runs.size());
+  for (const auto &run : runs) {
+    start = std::max(start, run.ready);
+    runs_start += run.tape->GetElapsedTime();
+    sources.push_back(run.tape);
+  }
+
+  using Merger = ParallelMerger<Value, Comparator, ThreadPool>;
+  // окна слияния занимают память, оставшуюся после служебных данных
+  const auto merger_memory_usage =
+      std::min(reservation.GetSize(), Merger::GetMemoryUsage(runs.size(), context.thread_count));
+  const Merger merger(
+      context.thread_pool,
+      comparator_,
+      context.thread_count,
+      std::max<size_t>(1, (reservation.GetSize() - merger_memory_usage) / sizeof(Value))
+  );
+  auto critical_path = merger.Merge(sources, *target);
+  const auto rewind_start = target->GetElapsedTime();
+  target->MoveToBegin();
+  critical_path += target->GetElapsedTime() - rewind_start;
+
+  auto merge_time = target->GetElapsedTime() - runs_start;
+  for (const auto &run : runs) {
+    merge_time += run.tape->GetElapsedTime();
+  }
+  context.AddDeviceTime(merge_time);
+  reservation.Release();
+  return start + critical_path;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+size_t TapeSorter<Value, Comparator, ThreadPool>::GetMergeMemoryUsage(const size_t run_count) {
+  // начала отсчета и ленты серий, их порядок и группы, дерево и состояние чтения
+  return run_count * (sizeof(Duration) + sizeof(TapeSharedPtr) + 2 * sizeof(size_t)) +
+         LoserTree<Value, Comparator>::GetMemoryUsage(run_count) +
+         ForecastingRunReader<Value, Comparator>::GetMemoryUsage(
+             run_count, MergeBufferLayout::kForecastSpareBufferCount
+         );
+}
 
-  // устройство для объединенных данных
-  TapeSharedPtr merged_tape = tape_provider_->Get();
-  BlockWriter merged_block(block_size, merged_tape);
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::LeaseBuffer(ParallelSortContext &context) const
+    -> std::shared_ptr<Lease> {
+  auto reservation =
+      context.memory.Reserve(context.buffers.GetCapacity() * sizeof(Value) + lease_overhead_);
+  return std::make_shared<Lease>(std::move(reservation), context.buffers.Borrow());
+}
 
-  const auto block_comparator = [this](const BlockReader &f, const BlockReader &s) {
-    return f.Read() != s.Read() && !comparator_(f.Read(), s.Read());
+template <typename Value, typename Comparator, typename ThreadPool>
+core::MemoryGovernor::Reservation TapeSorter<Value, Comparator, ThreadPool>::ReserveRest(
+    ParallelSortContext &context
+) const {
+  const auto limit = context.memory.GetLimit();
+  return context.memory.Reserve(
+      limit - std::min(limit, context.temp_tape_count * temp_tape_buffer_size_)
+  );
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::GetTempTape(ParallelSortContext &context) const
+    -> TapeSharedPtr {
+  /// Временная лента вместе с резервом памяти под ее буферы.
+  struct TempTape {
+    core::MemoryGovernor::Reservation reservation;
+    TapeUniquePtr tape;
+    std::atomic_size_t &count;
+
+    ~TempTape() {
+      --count;
+    }
   };
-  std::priority_queue<BlockReader, std::vector<BlockReader>, decltype(block_comparator)> blocks(
-      block_comparator
+
+  auto reservation = context.memory.Reserve(temp_tape_buffer_size_);
+  auto tape = unbuffered_temp_tapes_ ? tape_provider_->GetUnbuffered() : tape_provider_->Get();
+  ++context.temp_tape_count;
+  const auto temp_tape = std::make_shared<TempTape>(
+      std::move(reservation), std::move(tape), context.temp_tape_count
   );
+  return {temp_tape, temp_tape->tape.get()};
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+void TapeSorter<Value, Comparator, ThreadPool>::MergeToFreeTapeMemory(
+    ParallelSortContext &context, const size_t tapes_memory_limit, std::span<Value> memory
+) const {
+  // новой серии и результату слияния нужны еще две ленты
+  while ((context.temp_tape_count + 2) * temp_tape_buffer_size_ > tapes_memory_limit &&
+         context.block_count >= 2) {
+    std::vector<Run> runs(std::min<size_t>(context.merging_group_size, context.block_count));
+    for (auto &run : runs) {
+      run = context.Pop();
+    }
+    auto merged_run = DescribeMergedRun(runs);
+    context.block_count.fetch_sub(runs.size());
+    const auto lease = memory.empty() ? LeaseBuffer(context) : nullptr;
+    merged_run.tape = GetTempTape(context);
+    merged_run.ready =
+        MergeTapes(context, runs, lease ? lease->buffer.Get() : memory, merged_run.tape);
+    // ленты слитых серий освобождаются до следующей проверки
+    runs.clear();
+    context.Expect(merged_run.size);
+    context.Push(std::move(merged_run));
+  }
+}
 
-  for (const auto &tape : tapes) {
-    blocks.emplace(block_size, tape);
+template <typename Value, typename Comparator, typename ThreadPool>
+size_t TapeSorter<Value, Comparator, ThreadPool>::CountPreceding(
+    std::span<const Value> values, const Value &limit, const bool include_equal
+) const {
+  const auto precedes = [this, &limit, include_equal](const Value &value) {
+    return include_equal ? !comparator_(limit, value) : comparator_(value, limit);
+  };
+  size_t bound = 1;
+  while (bound <= values.size() && precedes(values[bound - 1])) {
+    bound *= 2;
   }
-  while (!blocks.empty()) {
-    BlockReader block = std::move(const_cast<BlockReader &>(blocks.top()));
-    blocks.pop();
-    merged_block.Write(block.Read());
-    if (block.MoveForward()) {
-      blocks.emplace(std::move(block));
+  // значения [0, bound / 2) предшествуют границе, а первое непредшествующее - не дальше bound - 1
+  const auto searched = values.first(std::min(bound, values.size())).subspan(bound / 2);
+  return bound / 2 +
+         static_cast<size_t>(std::ranges::partition_point(searched, precedes) - searched.begin());
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+std::vector<std::vector<size_t>> TapeSorter<Value, Comparator, ThreadPool>::GroupOverlappingRuns(
+    const std::vector<Run> &runs
+) const {
+  std::vector<size_t> order;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    if (runs[i].size != 0) {
+      order.push_back(i);
     }
   }
-  merged_block.Flush();
-  merged_tape->MoveToBegin();
-  context.Push(std::move(merged_tape));
+  std::ranges::sort(order, [this, &runs](const size_t f, const size_t s) {
+    return comparator_(runs[f].min, runs[s].min);
+  });
+  std::vector<std::vector<size_t>> groups;
+  const Value *max = nullptr;
+  for (const auto run : order) {
+    // равные границы не мешают записать серии друг за другом
+    if (max == nullptr || !comparator_(runs[run].min, *max)) {
+      groups.emplace_back();
+      max = &runs[run].max;
+    } else if (comparator_(*max, runs[run].max)) {
+      max = &runs[run].max;
+    }
+    groups.back().push_back(run);
+  }
+  return groups;
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::DescribeMergedRun(
+    const std::vector<Run> &runs
+) const -> Run {
+  Run merged;
+  for (const auto &run : runs) {
+    if (run.size == 0) {
+      continue;
+    }
+    if (merged.size == 0 || comparator_(run.min, merged.min)) {
+      merged.min = run.min;
+    }
+    if (merged.size == 0 || comparator_(merged.max, run.max)) {
+      merged.max = run.max;
+    }
+    merged.size += run.size;
+  }
+  return merged;
 }
 
 template <typename Value, typename Comparator, typename ThreadPool>
 void TapeSorter<Value, Comparator, ThreadPool>::WriteLeftPart(
-    Tape<Value> &src, const size_t block_size, Tape<Value> &target
+    const TapeSharedPtr &src,
+    const size_t block_size,
+    Tape<Value> &target,
+    core::IoExecutor &io_executor
 ) const {
-  auto values = src.ReadN(block_size);
-  while (!values.empty()) {
-    target.WriteN(values);
-    values = src.ReadN(block_size);
+  TapeBlockReader<Value> reader(block_size, src, &io_executor);
+  for (auto has_values = !reader.IsEnd(); has_values; has_values = reader.MoveToNextBlock()) {
+    target.WriteFrom(reader.ReadBlock());
+  }
+}
+
+template <typename Value, typename Comparator, typename ThreadPool>
+auto TapeSorter<Value, Comparator, ThreadPool>::ReleaseOutputTape(
+    ParallelSortContext &context, std::vector<Run> &runs, const TapeSharedPtr &output_tape
+) const -> Duration {
+  const auto run = std::move(*context.output_run);
+  context.output_run.reset();
+  const auto output_start = output_tape->GetElapsedTime();
+  // курсор стоит в конце серии, а значения, не превосходящие начала остальных серий, остаются
+  const auto others = DescribeMergedRun(runs);
+  auto moved = run.size;
+  if (others.size == 0 || !comparator_(others.min, run.max)) {
+    moved = 0;
+  } else if (!comparator_(others.min, run.min)) {
+    const auto max_scanned = run.size / kOutputRunScanDivisor;
+    for (size_t scanned = 0; scanned < max_scanned; ++scanned) {
+      output_tape->MoveBackward();
+      const auto value = output_tape->Read();
+      output_tape->MoveBackward();
+      if (!comparator_(others.min, *value)) {
+        // курсор на последнем остающемся значении
+        output_tape->MoveForward();
+        moved = scanned;
+        break;
+      }
+    }
+  }
+  if (moved == 0) {
+    const auto scan_time = output_tape->GetElapsedTime() - output_start;
+    context.AddDeviceTime(scan_time);
+    return run.ready + scan_time;
+  }
+  if (moved == run.size) {
+    output_tape->MoveToBegin();
+  }
+
+  // других задач уже нет, поэтому переносу отводится вся память, кроме буферов лент
+  TapeSharedPtr tape = GetTempTape(context);
+  auto reservation = ReserveRest(context);
+  context.buffers.Trim();
+  // за серией на выходной ленте могут быть старые данные, поэтому переносится ровно ее длина
+  std::vector<Value> values(
+      std::min(std::max<size_t>(1, reservation.GetSize() / sizeof(Value)), moved)
+  );
+  Value moved_min = run.min;
+  for (auto left = moved; left > 0;) {
+    const auto read = output_tape->ReadInto(std::span(values).first(std::min(left, values.size())));
+    if (read == 0) {
+      throw std::runtime_error("The run on the output tape is shorter than expected.");
+    }
+    if (left == moved) {
+      moved_min = values.front();
+    }
+    tape->WriteFrom(std::span(values).first(read));
+    left -= read;
+  }
+  reservation.Release();
+  tape->MoveToBegin();
+  // слияние пишется с первого перенесенного значения
+  if (moved == run.size) {
+    output_tape->MoveToBegin();
+  } else {
+    for (size_t i = 0; i < moved; ++i) {
+      output_tape->MoveBackward();
+    }
   }
+  const auto copy_time = output_tape->GetElapsedTime() - output_start + tape->GetElapsedTime();
+  context.AddDeviceTime(copy_time);
+  runs.push_back({std::move(tape), run.ready + copy_time, moved, moved_min, run.max});
+  return run.ready + copy_time;
 }
 
 }  // namespace sot
@@ -1,10 +1,13 @@
 #ifndef FILE_TAPE_PROVIDER_H
 #define FILE_TAPE_PROVIDER_H
 
+#include <unistd.h>
+
+#include <atomic>
 #include <filesystem>
-#include <random>
 
 #include "configuration.h"
+#include "direct_file_tape.h"
 #include "file_tape.h"
 #include "temp_tape_provider.h"
 
@@ -12,17 +15,26 @@ namespace sot {
 /**
  * \brief Класс, предоставляющий временные файловые реализации ленточных устройств.
  *
- * Создает файлы для устройств в системном временном каталоге.
- *
- * \warning При уничтожении экзмепляра данного класса, файлы устройств также удаляются.
+ * Создает файлы для устройств в системном временном каталоге. В зависимости от конфигурации
+ * предоставляет @link FileTape @endlink или @link DirectFileTape @endlink. Имя файла удаляется
+ * сразу после открытия устройства, поэтому место на диске освобождается, как только устройство
+ * уничтожено: ленты уже слитых серий не накапливаются до конца сортировки, а файлы не остаются
+ * после аварийного завершения. Метод @link Get @endlink можно вызывать из нескольких потоков.
  *
  * \tparam Value тип элементов ленты.
  */
 template <typename Value>
 class TempFileTapeProvider : public TempTapeProvider<Value> {
  public:
+  /// Ключ в конфигурации, включающий использование @link DirectFileTape @endlink (0 или 1).
+  static constexpr auto kDirectIoKey = "temp_tape_direct_io";
+
+  /// Значение по умолчанию: используются ленты на основе файловых потоков.
+  static constexpr uint64_t kDirectIoDefault = 0;
+
   /**
-   * Конфигурация используется при создании устройств (см. @link FileTape @endlink).
+   * Конфигурация используется при создании устройств (см. @link FileTape @endlink и
+   * @link DirectFileTape @endlink).
    */
   explicit TempFileTapeProvider(const Configuration &config);
   /**
@@ -31,17 +43,32 @@ class TempFileTapeProvider : public TempTapeProvider<Value> {
   ~TempFileTapeProvider() override;
 
   [[nodiscard]] std::unique_ptr<Tape<Value>> Get() const override;
+  /**
+   * \brief Предоставляет @link FileTape @endlink без буфера потока, даже если включен
+   * @link DirectFileTape @endlink: его чанкам нужна память.
+   */
+  [[nodiscard]] std::unique_ptr<Tape<Value>> GetUnbuffered() const override;
+  [[nodiscard]] size_t GetBufferSize() const override;
+
+  /**
+   * \brief Получить каталог, в котором создаются файлы устройств.
+   */
+  [[nodiscard]] const std::filesystem::path &GetDirectory() const;
 
  private:
-  inline static std::mt19937_64 generator_{std::random_device()()};
+  /// Количество созданных в процессе провайдеров, используется для именования их каталогов.
+  inline static std::atomic_uint64_t provider_count_ = 0;
 
   const Configuration &config_;
   const std::filesystem::path prefix_;
+  const bool direct_io_;
+  /// Индекс следующего файла устройства.
+  mutable std::atomic_uint64_t next_file_index_ = 0;
 
   /**
-   * \brief Сгенерировать случайный индекс файла или каталога.
+   * \brief Получить путь к файлу очередного устройства.
    */
-  static uint64_t GenerateRandomIndex();
+  std::filesystem::path GetNextFileName() const;
 };
 
 template <typename Value>
@@ -49,8 +76,9 @@ TempFileTapeProvider<Value>::TempFileTapeProvider(const Configuration &config)
     : config_(config),
       prefix_(
           std::filesystem::temp_directory_path() /
-          (std::to_string(GenerateRandomIndex()) + "_tapes")
-      ) {
+          (std::to_string(getpid()) + "_" + std::to_string(provider_count_++) + "_tapes")
+      ),
+      direct_io_(config.GetProperty(kDirectIoKey, kDirectIoDefault) != 0) {
   create_directories(prefix_);
 }
 
@@ -61,14 +89,40 @@ TempFileTapeProvider<Value>::~TempFileTapeProvider() {
 
 template <typename Value>
 std::unique_ptr<Tape<Value>> TempFileTapeProvider<Value>::Get() const {
-  return std::make_unique<FileTape<Value>>(
-      config_, prefix_ / std::to_string(GenerateRandomIndex())
-  );
+  const auto file_name = GetNextFileName();
+  std::unique_ptr<Tape<Value>> tape;
+  if (direct_io_) {
+    tape = std::make_unique<DirectFileTape<Value>>(config_, file_name);
+  } else {
+    tape = std::make_unique<FileTape<Value>>(config_, file_name);
+  }
+  // устройство продолжает работать с открытым файлом, а данные удаляются при его закрытии
+  std::filesystem::remove(file_name);
+  return tape;
+}
+
+template <typename Value>
+std::unique_ptr<Tape<Value>> TempFileTapeProvider<Value>::GetUnbuffered() const {
+  const auto file_name = GetNextFileName();
+  auto tape = std::make_unique<FileTape<Value>>(config_, file_name, false);
+  std::filesystem::remove(file_name);
+  return tape;
+}
+
+template <typename Value>
+size_t TempFileTapeProvider<Value>::GetBufferSize() const {
+  return direct_io_ ? DirectFileTape<Value>::GetBufferSize(config_)
+                    : FileTape<Value>::GetBufferSize(config_);
+}
+
+template <typename Value>
+const std::filesystem::path &TempFileTapeProvider<Value>::GetDirectory() const {
+  return prefix_;
 }
 
 template <typename Value>
-uint64_t TempFileTapeProvider<Value>::GenerateRandomIndex() {
-  return generator_();
+std::filesystem::path TempFileTapeProvider<Value>::GetNextFileName() const {
+  return prefix_ / std::to_string(next_file_index_++);
 }
 
 }  // namespace sot
@@ -22,6 +22,22 @@ class TempTapeProvider {
    * \brief Предоставляет ленточное устройство.
    */
   [[nodiscard]] virtual std::unique_ptr<Tape<Value>> Get() const = 0;
+  /**
+   * \brief Предоставляет ленточное устройство без собственных буферов.
+   *
+   * Используется, когда буферы лент не вмещает лимит памяти. Провайдеры, ленты которых занимают
+   * буферы, переопределяют метод.
+   */
+  [[nodiscard]] virtual std::unique_ptr<Tape<Value>> GetUnbuffered() const {
+    return Get();
+  }
+  /**
+   * \brief Получить объем памяти в байтах, который каждая предоставленная лента занимает
+   * собственными буферами, пока существует.
+   */
+  [[nodiscard]] virtual size_t GetBufferSize() const {
+    return 0;
+  }
 };
 
 }  // namespace sot
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include "core/simd_sort.h"
+#include "radix_sort.h"
+#include "test_utils.h"
+
+namespace sot::test::benchmark {
+
+using namespace ::benchmark;
+
+using Value = std::int32_t;
+
+/**
+ * \brief Замерить сортировку блока заданной функцией.
+ * \param sort функция, сортирующая блок с использованием вспомогательного буфера.
+ */
+template <typename Sort>
+void SortBlock(State &state, Sort sort) {
+  const auto block_size = static_cast<size_t>(state.range(0));
+  const auto values = GenerateRandomArray<Value>(block_size, 42);
+  std::vector<Value> block(block_size);
+  std::vector<Value> scratch(block_size);
+  for (auto _ : state) {
+    state.PauseTiming();
+    block = values;
+    state.ResumeTiming();
+
+    sort(block, scratch);
+    DoNotOptimize(block.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * block_size));
+}
+
+void StdSortBlock(State &state) {
+  SortBlock(state, [](std::vector<Value> &block, std::vector<Value> &) {
+    std::sort(block.begin(), block.end(), std::less<Value>());
+  });
+}
+BENCHMARK(StdSortBlock)->RangeMultiplier(10)->Range(1000, 10000000);
+
+void RadixSortBlock(State &state) {
+  SortBlock(state, [](std::vector<Value> &block, std::vector<Value> &scratch) {
+    RadixSorter<Value>::Sort(block, scratch);
+  });
+}
+BENCHMARK(RadixSortBlock)->RangeMultiplier(10)->Range(1000, 10000000);
+
+void SimdSortBlock(State &state) {
+  const auto isa = static_cast<core::SimdIsa>(state.range(1));
+  if (isa > core::GetSupportedSimdIsa()) {
+    state.SkipWithError("The instruction set isn't supported by the CPU.");
+    return;
+  }
+  SortBlock(state, [isa](std::vector<Value> &block, std::vector<Value> &scratch) {
+    core::SimdSorter<Value>::Sort(block, scratch, isa);
+  });
+}
+BENCHMARK(SimdSortBlock)
+    ->ArgNames({"", "isa"})
+    ->ArgsProduct(
+        {CreateRange(1000, 10000000, 10),
+         {static_cast<int64_t>(core::SimdIsa::kAvx2), static_cast<int64_t>(core::SimdIsa::kAvx512)}}
+    );
+
+}  // namespace sot::test::benchmark
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include "file_tape.h"
+#include "test_base.h"
+#include "test_utils.h"
+
+namespace sot::test::benchmark {
+
+using namespace ::benchmark;
+
+using Value = std::int32_t;
+
+class FileTapeBenchmark : public TestBase, public Fixture {
+ public:
+  static constexpr size_t kValueCount = 1 << 20;
+
+  path file_path_;
+
+  void SetUp(State &st) override;
+  void TearDown(State &st) override;
+};
+
+void FileTapeBenchmark::SetUp(State &st) {
+  Fixture::SetUp(st);
+  TestBase::SetUp("FileTapeBenchmark", "bench");
+  file_path_ = file_prefix_ / "file";
+  CreateFileWithBinaryContent(file_path_, GenerateRandomArray<Value>(kValueCount));
+}
+
+void FileTapeBenchmark::TearDown(State &st) {
+  Fixture::TearDown(st);
+}
+
+BENCHMARK_DEFINE_F(FileTapeBenchmark, ReadByValue)(State &state) {
+  config_.SetFileBufferSize(state.range(0));
+  for (auto _ : state) {
+    FileTape<Value, false> tape(config_, file_path_);
+    while (const auto value = tape.Read()) {
+      DoNotOptimize(value);
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kValueCount * sizeof(Value)));
+}
+BENCHMARK_REGISTER_F(FileTapeBenchmark, ReadByValue)
+    ->ArgName("buffer_size")
+    ->Arg(0)
+    ->Arg(4_KiB)
+    ->Arg(64_KiB)
+    ->Arg(1_MiB);
+
+BENCHMARK_DEFINE_F(FileTapeBenchmark, ReadIntoBlocks)(State &state) {
+  std::vector<Value> block(state.range(0));
+  for (auto _ : state) {
+    FileTape<Value, false> tape(config_, file_path_);
+    while (tape.ReadInto(block) != 0) {
+      DoNotOptimize(block.data());
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kValueCount * sizeof(Value)));
+}
+BENCHMARK_REGISTER_F(FileTapeBenchmark, ReadIntoBlocks)
+    ->ArgName("block_size")
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(4096)
+    ->Arg(65536);
+
+BENCHMARK_DEFINE_F(FileTapeBenchmark, WriteFromBlocks)(State &state) {
+  const auto values = GenerateRandomArray<Value>(kValueCount);
+  const auto block_size = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    FileTape<Value, true> tape(config_, file_prefix_ / "output");
+    for (size_t pos = 0; pos < values.size(); pos += block_size) {
+      tape.WriteFrom(std::span(values).subspan(pos, std::min(block_size, values.size() - pos)));
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kValueCount * sizeof(Value)));
+}
+BENCHMARK_REGISTER_F(FileTapeBenchmark, WriteFromBlocks)
+    ->ArgName("block_size")
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(4096)
+    ->Arg(65536);
+
+}  // namespace sot::test::benchmark
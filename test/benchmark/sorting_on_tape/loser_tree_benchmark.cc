@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+
+#include <queue>
+
+#include "loser_tree.h"
+#include "memory_tape.h"
+#include "tape_block_reader.h"
+#include "test_utils.h"
+
+namespace sot::test::benchmark {
+
+using namespace ::benchmark;
+
+using Value = std::int32_t;
+using BlockReader = TapeBlockReader<Value>;
+
+/**
+ * \brief Подготовить отсортированные части массива для слияния.
+ */
+std::vector<std::vector<Value>> GenerateSortedRuns(
+    const size_t run_count, const size_t value_count
+) {
+  auto values = GenerateRandomArray<Value>(value_count, 42);
+  std::vector<std::vector<Value>> runs(run_count);
+  const auto run_size = value_count / run_count;
+  for (size_t i = 0; i < run_count; ++i) {
+    const auto begin = values.begin() + static_cast<std::ptrdiff_t>(i * run_size);
+    const auto end = i + 1 == run_count ? values.end() : begin + run_size;
+    runs[i].assign(begin, end);
+    std::ranges::sort(runs[i]);
+  }
+  return runs;
+}
+
+/**
+ * \brief Создать читателей для всех частей массива.
+ */
+std::vector<std::shared_ptr<Tape<Value>>> MakeTapes(const std::vector<std::vector<Value>> &runs) {
+  std::vector<std::shared_ptr<Tape<Value>>> tapes;
+  for (const auto &run : runs) {
+    tapes.emplace_back(std::make_shared<MemoryTape<Value>>(run));
+  }
+  return tapes;
+}
+
+constexpr size_t kValueCount = 1 << 20;
+
+void HeapMerge(State &state) {
+  const auto run_count = static_cast<size_t>(state.range(0));
+  const auto runs = GenerateSortedRuns(run_count, kValueCount);
+  const auto block_size = kValueCount / (run_count + 1);
+  std::vector<Value> merged(kValueCount);
+  for (auto _ : state) {
+    state.PauseTiming();
+    const auto tapes = MakeTapes(runs);
+    state.ResumeTiming();
+
+    const auto block_comparator = [](const BlockReader &f, const BlockReader &s) {
+      return f.Read() != s.Read() && !std::less<Value>()(f.Read(), s.Read());
+    };
+    std::priority_queue<BlockReader, std::vector<BlockReader>, decltype(block_comparator)> blocks(
+        block_comparator
+    );
+    for (const auto &tape : tapes) {
+      blocks.emplace(block_size, tape);
+    }
+    size_t pos = 0;
+    while (!blocks.empty()) {
+      BlockReader block = std::move(const_cast<BlockReader &>(blocks.top()));
+      blocks.pop();
+      merged[pos++] = block.Read();
+      if (block.MoveForward()) {
+        blocks.emplace(std::move(block));
+      }
+    }
+    DoNotOptimize(merged.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kValueCount));
+}
+BENCHMARK(HeapMerge)->ArgName("fan_in")->Arg(2)->Arg(8)->Arg(64)->Arg(256)->Arg(1000);
+
+void LoserTreeMerge(State &state) {
+  const auto run_count = static_cast<size_t>(state.range(0));
+  const auto runs = GenerateSortedRuns(run_count, kValueCount);
+  const auto block_size = kValueCount / (run_count + 1);
+  std::vector<Value> merged(kValueCount);
+  for (auto _ : state) {
+    state.PauseTiming();
+    const auto tapes = MakeTapes(runs);
+    state.ResumeTiming();
+
+    std::vector<BlockReader> readers;
+    readers.reserve(tapes.size());
+    LoserTree<Value> sources(tapes.size());
+    for (const auto &tape : tapes) {
+      const auto &reader = readers.emplace_back(block_size, tape);
+      if (!reader.IsEnd()) {
+        sources.Push(readers.size() - 1, reader.Read());
+      }
+    }
+    sources.Build();
+    size_t pos = 0;
+    while (!sources.Empty()) {
+      merged[pos++] = sources.TopValue();
+      auto &reader = readers[sources.Top()];
+      if (reader.MoveForward()) {
+        sources.ReplaceTop(reader.Read());
+      } else {
+        sources.PopTop();
+      }
+    }
+    DoNotOptimize(merged.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kValueCount));
+}
+BENCHMARK(LoserTreeMerge)->ArgName("fan_in")->Arg(2)->Arg(8)->Arg(64)->Arg(256)->Arg(1000);
+
+}  // namespace sot::test::benchmark
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 
+#include "memory_temp_tape_provider.h"
 #include "tape_sorter_test_base.h"
 
 namespace sot::test::benchmark {
@@ -106,6 +107,56 @@ BENCHMARK_REGISTER_F(TapeSorterBenchmark, WithDifferentDelays)
     ->ArgNames({"delay_multiplier", "threads"})
     ->ArgsProduct({{1, 2, 10}, {1, 2, 8}});
 
+BENCHMARK_DEFINE_F(TapeSorterBenchmark, WithMemoryTempTapes)(State &state) {
+  constexpr auto value_count = 100000;
+  constexpr auto mem_divider = 100;
+  const auto merge_group_size = state.range(0);
+  const auto thread_count = state.range(1);
+  config_.SetZeroDurations();
+  SetUpMemoryLimit(value_count, mem_divider);
+  config_.SetMaxThreadCount(thread_count);
+  config_.SetMaxValueCountPerThread(value_count / mem_divider / thread_count);
+  config_.SetMaxMergingGroupSize(merge_group_size);
+  // без задержек и файлов измеряется только стоимость самого алгоритма
+  tape_provider_ = std::make_shared<MemoryTempTapeProvider<Value>>();
+  const auto values = InitInputDataWithRandomValues(value_count);
+  for (auto _ : state) {
+    const auto sorted_values = SortTape();
+  }
+}
+BENCHMARK_REGISTER_F(TapeSorterBenchmark, WithMemoryTempTapes)
+    ->ArgNames({"merge_group_size", "threads"})
+    ->ArgsProduct({{2, 10, 50}, {1, 2, 8}});
+
+BENCHMARK_DEFINE_F(TapeSorterBenchmark, WithVirtualClock)(State &state) {
+  constexpr auto mem_divider = 50;
+  constexpr auto merge_group_size = 8;
+  constexpr auto thread_count = 4;
+  const auto value_count = state.range(0);
+  const auto delay_multiplier = state.range(1);
+  SetUpTapeDurations(delay_multiplier);
+  config_.SetLatencyMode(LatencyMode::kVirtualClock);
+  SetUpMemoryLimit(value_count, mem_divider);
+  config_.SetMaxThreadCount(thread_count);
+  config_.SetMaxValueCountPerThread(value_count / mem_divider / thread_count);
+  config_.SetMaxMergingGroupSize(merge_group_size);
+  const auto values = InitInputDataWithRandomValues(value_count);
+  SortStatistics statistics;
+  for (auto _ : state) {
+    FileTape<Value, false> input_tape(config_, input_file_path_);
+    FileTape<Value> output_tape(config_, output_file_path_);
+    statistics = TapeSorter<Value>(config_, tape_provider_).Sort(input_tape, output_tape);
+  }
+  // время по виртуальным часам не зависит от планировщика, поэтому сообщается отдельно
+  state.counters["device_time_s"] = std::chrono::duration<double>(statistics.device_time).count();
+  state.counters["critical_path_s"] =
+      std::chrono::duration<double>(statistics.critical_path).count();
+}
+BENCHMARK_REGISTER_F(TapeSorterBenchmark, WithVirtualClock)
+    ->ArgNames({"values", "delay_multiplier"})
+    ->ArgsProduct({{100000, 1000000}, {1, 10}})
+    ->Unit(kMillisecond);
+
 BENCHMARK_MAIN();
 
 }  // namespace sot::test::benchmark
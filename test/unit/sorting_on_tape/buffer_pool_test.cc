@@ -0,0 +1,66 @@
+#include "core/buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace sot::test {
+
+using namespace core;
+
+using Value = std::int32_t;
+
+TEST(BufferPoolTest, ReturnedBufferIsReused) {
+  BufferPool<Value> pool(1000);
+  Value *data = nullptr;
+  {
+    const auto buffer = pool.Borrow();
+    data = buffer.Get().data();
+    EXPECT_EQ(1000, buffer.Get().size());
+  }
+  const auto first = pool.Borrow();
+  const auto second = pool.Borrow();
+
+  EXPECT_EQ(data, first.Get().data());
+  EXPECT_NE(data, second.Get().data());
+  EXPECT_EQ(2, pool.GetAllocatedCount());
+}
+
+TEST(BufferPoolTest, BuffersAreAligned) {
+  BufferPool<Value> pool(3);
+  BufferPool<Value> huge_page_pool(BufferPool<Value>::kHugePageSize / sizeof(Value), true);
+
+  for (size_t i = 0; i < 3; ++i) {
+    const auto buffer = pool.Borrow();
+    const auto huge_page_buffer = huge_page_pool.Borrow();
+
+    const auto address = reinterpret_cast<std::uintptr_t>(buffer.Get().data());
+    const auto huge_page_address = reinterpret_cast<std::uintptr_t>(huge_page_buffer.Get().data());
+    EXPECT_EQ(0, address % BufferPool<Value>::kAlignment);
+    EXPECT_EQ(0, huge_page_address % BufferPool<Value>::kHugePageSize);
+  }
+}
+
+TEST(BufferPoolTest, TrimFreesOnlyReturnedBuffers) {
+  BufferPool<Value> pool(10);
+  auto borrowed = pool.Borrow();
+  {
+    const auto returned = pool.Borrow();
+  }
+
+  pool.Trim();
+  EXPECT_EQ(1, pool.GetAllocatedCount());
+
+  auto moved = std::move(borrowed);
+  EXPECT_TRUE(borrowed.Get().empty());
+  moved = {};
+  pool.Trim();
+  EXPECT_EQ(0, pool.GetAllocatedCount());
+  EXPECT_EQ(2, pool.GetPeakAllocatedCount());
+}
+
+TEST(BufferPoolTest, ZeroCapacity) {
+  EXPECT_THROW(BufferPool<Value>(0), std::invalid_argument);
+}
+
+}  // namespace sot::test
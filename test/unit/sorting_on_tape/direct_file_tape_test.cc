@@ -0,0 +1,219 @@
+#include "direct_file_tape.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/eventfd.h>
+
+#include "fake_configuration.h"
+#include "file_utils.h"
+#include "test_base.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using namespace files;
+
+using Value = std::int32_t;
+
+class DirectFileTapeTest : public TestBase, public testing::Test {
+ public:
+  static constexpr size_t kChunkSize = 4_KiB;
+  /// Количество значений, занимающее несколько чанков и не кратное размеру чанка.
+  static constexpr size_t kValueCount = 5 * kChunkSize / sizeof(Value) + 123;
+
+  path file_path_;
+
+  DirectFileTapeTest();
+};
+
+DirectFileTapeTest::DirectFileTapeTest() {
+  TestBase::SetUp(
+      "DirectFileTapeTest", testing::UnitTest::GetInstance()->current_test_info()->name()
+  );
+  file_path_ = file_prefix_ / "file";
+  config_.SetZeroDurations();
+  config_.SetDirectIoChunkSize(kChunkSize);
+}
+
+TEST_F(DirectFileTapeTest, WriteAndReadSeveralChunks) {
+  const auto expected_values = GenerateRandomArray<Value>(kValueCount);
+  DirectFileTape<Value> under_test(config_, file_path_);
+
+  const auto written = under_test.WriteN(expected_values);
+  under_test.MoveToBegin();
+  const auto actual_values = ReadAllFromTape(under_test);
+
+  EXPECT_EQ(expected_values.size(), written);
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(DirectFileTapeTest, WriteByValueAndReadByValue) {
+  const auto expected_values = GenerateRandomArray<Value>(kValueCount);
+  DirectFileTape<Value> under_test(config_, file_path_);
+
+  for (const auto value : expected_values) {
+    under_test.Write(value);
+  }
+  under_test.MoveToBegin();
+  std::vector<Value> actual_values;
+  while (const auto value = under_test.Read()) {
+    actual_values.push_back(*value);
+  }
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(DirectFileTapeTest, FileContainsWrittenValuesAfterDestruction) {
+  const auto expected_values = GenerateRandomArray<Value>(kValueCount);
+  {
+    DirectFileTape<Value> under_test(config_, file_path_);
+    under_test.WriteN(expected_values);
+  }
+
+  EXPECT_EQ(expected_values.size() * sizeof(Value), file_size(file_path_))
+      << "The file must be truncated to the written content";
+  FileTape<Value, false> file_tape(config_, file_path_);
+  VerifyContentEquals(expected_values, ReadAllFromTape(file_tape));
+}
+
+TEST_F(DirectFileTapeTest, OverwriteInTheMiddle) {
+  auto expected_values = GenerateRandomArray<Value>(kValueCount);
+  const std::vector<Value> patch(kChunkSize / sizeof(Value), 42);
+  constexpr size_t patch_pos = kChunkSize / sizeof(Value) / 2 * 3;
+  DirectFileTape<Value> under_test(config_, file_path_);
+
+  under_test.WriteN(expected_values);
+  under_test.MoveToBegin();
+  for (size_t i = 0; i < patch_pos; ++i) {
+    under_test.MoveForward();
+  }
+  under_test.WriteN(patch);
+  under_test.MoveToBegin();
+  const auto actual_values = ReadAllFromTape(under_test);
+
+  std::ranges::copy(patch, expected_values.begin() + patch_pos);
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(DirectFileTapeTest, ReadExistingFile) {
+  const auto expected_values = GenerateRandomArray<Value>(kValueCount);
+  CreateFileWithBinaryContent(file_path_, expected_values);
+  DirectFileTape<Value> under_test(config_, file_path_);
+
+  const auto actual_values = ReadAllFromTape(under_test);
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(DirectFileTapeTest, ReadWithSingleBufferPair) {
+  config_.SetDirectIoQueueDepth(2);
+  const auto expected_values = GenerateRandomArray<Value>(kValueCount);
+  DirectFileTape<Value> under_test(config_, file_path_);
+
+  under_test.WriteN(expected_values);
+  under_test.MoveToBegin();
+  const auto actual_values = ReadAllFromTape(under_test);
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(DirectFileTapeTest, InvalidChunkSize) {
+  config_.SetDirectIoChunkSize(kChunkSize + 1);
+
+  EXPECT_THROW(DirectFileTape<Value>(config_, file_path_), std::invalid_argument);
+}
+
+TEST_F(DirectFileTapeTest, SyncIoQueueFallback) {
+  const auto expected_values = GenerateRandomArray<Value>(kChunkSize / sizeof(Value));
+  const auto io_queue = core::IoQueue::Create(1, core::IoQueue::Kind::kSync);
+  const auto fd = open(file_path_.c_str(), O_RDWR | O_CREAT, 0644);
+  ASSERT_LE(0, fd);
+  std::vector<Value> actual_values(expected_values.size());
+
+  io_queue->SubmitWrite(fd, expected_values.data(), kChunkSize, 0, 1);
+  const auto written = io_queue->Wait(1);
+  io_queue->SubmitRead(fd, actual_values.data(), kChunkSize, 0, 2);
+  const auto read = io_queue->Wait(2);
+  close(fd);
+
+  EXPECT_EQ(core::IoQueue::Kind::kSync, io_queue->GetKind());
+  EXPECT_EQ(kChunkSize, written);
+  EXPECT_EQ(kChunkSize, read);
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(DirectFileTapeTest, IoQueueShortReadAtTheEndOfFile) {
+  const auto expected_values = GenerateRandomArray<Value>(kChunkSize / sizeof(Value) / 2);
+  CreateFileWithBinaryContent(file_path_, expected_values);
+  const auto io_queue = core::IoQueue::Create(2);
+  const auto fd = open(file_path_.c_str(), O_RDONLY);
+  ASSERT_LE(0, fd);
+  std::vector<Value> actual_values(kChunkSize / sizeof(Value));
+
+  io_queue->SubmitRead(fd, actual_values.data(), kChunkSize, 0, 1);
+  const auto read = io_queue->Wait(1);
+  io_queue->SubmitRead(fd, actual_values.data(), kChunkSize, kChunkSize, 2);
+  const auto read_past_end = io_queue->Wait(2);
+  close(fd);
+
+  // DirectFileTape дочитывает остаток чанка, пока чтение не вернет 0 или не дойдет до конца файла
+  EXPECT_EQ(kChunkSize / 2, read);
+  EXPECT_EQ(0, read_past_end);
+  actual_values.resize(expected_values.size());
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(DirectFileTapeTest, IoQueueAcceptsMoreOperationsThanDepth) {
+  constexpr size_t chunk_count = 8;
+  const auto expected_values = GenerateRandomArray<Value>(chunk_count * kChunkSize / sizeof(Value));
+  CreateFileWithBinaryContent(file_path_, expected_values);
+  const auto io_queue = core::IoQueue::Create(1);
+  const auto fd = open(file_path_.c_str(), O_RDONLY);
+  ASSERT_LE(0, fd);
+  std::vector<Value> actual_values(expected_values.size());
+
+  // все чтения отправляются до ожидания любого из них, а результаты забираются в обратном порядке
+  for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+    const auto offset = chunk * kChunkSize;
+    io_queue->SubmitRead(
+        fd, actual_values.data() + offset / sizeof(Value), kChunkSize, offset, chunk
+    );
+  }
+  std::vector<ssize_t> read(chunk_count);
+  for (size_t chunk = chunk_count; chunk-- > 0;) {
+    read[chunk] = io_queue->Wait(chunk);
+  }
+  close(fd);
+
+  EXPECT_EQ(std::vector<ssize_t>(chunk_count, kChunkSize), read);
+  VerifyContentEquals(expected_values, actual_values);
+  EXPECT_THROW(io_queue->Wait(0), std::logic_error);
+}
+
+TEST_F(DirectFileTapeTest, IoQueueReturnsRequestErrorWithoutFallback) {
+  const auto expected_values = GenerateRandomArray<Value>(kChunkSize / sizeof(Value));
+  CreateFileWithBinaryContent(file_path_, expected_values);
+  const auto io_queue = core::IoQueue::Create(2);
+  const auto kind = io_queue->GetKind();
+  const auto event_fd = eventfd(0, EFD_NONBLOCK);
+  const auto fd = open(file_path_.c_str(), O_RDONLY);
+  ASSERT_LE(0, event_fd);
+  ASSERT_LE(0, fd);
+  std::vector<Value> actual_values(expected_values.size());
+
+  // чтение eventfd в буфер меньше 8 байт отклоняется с EINVAL
+  io_queue->SubmitRead(event_fd, actual_values.data(), sizeof(Value), 0, 1);
+  const auto failed = io_queue->Wait(1);
+  io_queue->SubmitRead(fd, actual_values.data(), kChunkSize, 0, 2);
+  const auto read = io_queue->Wait(2);
+  close(fd);
+  close(event_fd);
+
+  // ошибка отдельной операции не переключает очередь на синхронное выполнение
+  EXPECT_EQ(-EINVAL, failed);
+  EXPECT_EQ(kind, io_queue->GetKind());
+  EXPECT_EQ(kChunkSize, read);
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+}  // namespace sot::test
@@ -2,8 +2,11 @@
 #define FAKE_CONFIGURATION_H
 
 #include "configuration.h"
+#include "direct_file_tape.h"
 #include "file_tape.h"
+#include "tape_latency.h"
 #include "tape_sorter.h"
+#include "temp_file_tape_provider.h"
 
 namespace sot::test {
 
@@ -43,6 +46,26 @@ class FakeConfiguration : public Configuration {
    * \brief Установить нулевое значение всех задержек.
    */
   void SetZeroDurations();
+  /**
+   * \brief Установить способ эмуляции задержек.
+   */
+  void SetLatencyMode(LatencyMode mode);
+  /**
+   * \brief Установить размер буфера файлового потока в байтах.
+   */
+  void SetFileBufferSize(size_t size);
+  /**
+   * \brief Включить или выключить использование O_DIRECT для временных лент.
+   */
+  void SetTempTapeDirectIo(bool enabled);
+  /**
+   * \brief Установить размер чанка ленты с O_DIRECT в байтах.
+   */
+  void SetDirectIoChunkSize(size_t size);
+  /**
+   * \brief Установить количество буферов чанков ленты с O_DIRECT.
+   */
+  void SetDirectIoQueueDepth(size_t depth);
   /**
    * \brief Установить ограничение по использованию памяти в байтах.
    */
@@ -59,34 +82,48 @@ class FakeConfiguration : public Configuration {
    * \brief Установить максимальное количество потоков.
    */
   void SetMaxThreadCount(size_t count);
+  /**
+   * \brief Установить способ формирования начальных серий.
+   */
+  void SetRunFormationMode(RunFormationMode mode);
+  /**
+   * \brief Включить размещение буферов блоков на больших страницах.
+   */
+  void SetHugePageBuffers(bool enabled);
+  /**
+   * \brief Включить автоматическую настройку сортировки.
+   */
+  void SetAutoTune(bool enabled);
 };
 
 template <typename Duration>
 void FakeConfiguration::SetReadDuration(Duration duration) {
-  params[FileTape<>::kReadDurationKey] = std::chrono::floor<FileTape<>::Duration>(duration).count();
+  params[TapeLatency::kReadDurationKey] =
+      std::chrono::floor<TapeLatency::Duration>(duration).count();
 }
 
 template <typename Duration>
 void FakeConfiguration::SetWriteDuration(Duration duration) {
-  params[FileTape<>::kWriteDurationKey] =
-      std::chrono::floor<FileTape<>::Duration>(duration).count();
+  params[TapeLatency::kWriteDurationKey] =
+      std::chrono::floor<TapeLatency::Duration>(duration).count();
 }
 
 template <typename Duration>
 void FakeConfiguration::SetMoveDuration(Duration duration) {
-  params[FileTape<>::kMoveDurationKey] = std::chrono::floor<FileTape<>::Duration>(duration).count();
+  params[TapeLatency::kMoveDurationKey] =
+      std::chrono::floor<TapeLatency::Duration>(duration).count();
 }
 
 template <typename Duration>
 void FakeConfiguration::SetRewindDuration(Duration duration) {
-  params[FileTape<>::kRewindDurationKey] =
-      std::chrono::floor<FileTape<>::Duration>(duration).count();
+  params[TapeLatency::kRewindDurationKey] =
+      std::chrono::floor<TapeLatency::Duration>(duration).count();
 }
 
 template <typename Duration>
 void FakeConfiguration::SetGapCrossDuration(Duration duration) {
-  params[FileTape<>::kGapCrossDurationKey] =
-      std::chrono::floor<FileTape<>::Duration>(duration).count();
+  params[TapeLatency::kGapCrossDurationKey] =
+      std::chrono::floor<TapeLatency::Duration>(duration).count();
 }
 
 inline void FakeConfiguration::SetZeroDurations() {
@@ -97,6 +134,26 @@ inline void FakeConfiguration::SetZeroDurations() {
   SetGapCrossDuration(0us);
 }
 
+inline void FakeConfiguration::SetLatencyMode(const LatencyMode mode) {
+  params[TapeLatency::kLatencyModeKey] = static_cast<std::uint64_t>(mode);
+}
+
+inline void FakeConfiguration::SetFileBufferSize(const size_t size) {
+  params[FileTape<>::kBufferSizeKey] = size;
+}
+
+inline void FakeConfiguration::SetTempTapeDirectIo(const bool enabled) {
+  params[TempFileTapeProvider<FileTape<>::ValueT>::kDirectIoKey] = enabled ? 1 : 0;
+}
+
+inline void FakeConfiguration::SetDirectIoChunkSize(const size_t size) {
+  params[DirectFileTape<>::kChunkSizeKey] = size;
+}
+
+inline void FakeConfiguration::SetDirectIoQueueDepth(const size_t depth) {
+  params[DirectFileTape<>::kQueueDepthKey] = depth;
+}
+
 inline void FakeConfiguration::SetMemoryLimit(const size_t limit_size) {
   params[TapeSorter<FileTape<>::ValueT>::kMemoryLimitKey] = limit_size;
 }
@@ -113,6 +170,18 @@ inline void FakeConfiguration::SetMaxThreadCount(const size_t count) {
   params[TapeSorter<FileTape<>::ValueT>::kMaxThreadCountKey] = count;
 }
 
+inline void FakeConfiguration::SetRunFormationMode(const RunFormationMode mode) {
+  params[TapeSorter<FileTape<>::ValueT>::kRunFormationModeKey] = static_cast<std::uint64_t>(mode);
+}
+
+inline void FakeConfiguration::SetHugePageBuffers(const bool enabled) {
+  params[TapeSorter<FileTape<>::ValueT>::kHugePageBuffersKey] = enabled;
+}
+
+inline void FakeConfiguration::SetAutoTune(const bool enabled) {
+  params[TapeSorter<FileTape<>::ValueT>::kAutoTuneKey] = enabled;
+}
+
 }  // namespace sot::test
 
 #endif  // FAKE_CONFIGURATION_H
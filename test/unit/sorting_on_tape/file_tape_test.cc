@@ -200,6 +200,71 @@ TEST_F(FileTapeTest, WriteInt) {
   VerifyContentEquals(written_numbers, actual_numbers);
 }
 
+TEST_F(FileTapeTest, ReadIntoBuffer) {
+  constexpr auto part_size = kDefaultTestContent.size() / 2;
+  FileTape under_test = InitTapeWithContent();
+  std::vector<char> buffer(part_size);
+
+  const auto read = under_test.ReadInto(buffer);
+
+  EXPECT_EQ(part_size, read);
+  VerifyContentEquals(kDefaultTestContent.substr(0, part_size), {buffer.begin(), buffer.end()});
+  EXPECT_EQ(kDefaultTestContent[part_size], under_test.Read())
+      << "After reading into buffer, the cursor must be after the last read value";
+}
+
+TEST_F(FileTapeTest, ReadIntoBufferLargerThanContent) {
+  FileTape under_test = InitTapeWithContent();
+  std::vector<char> buffer(kDefaultTestContent.size() * 2);
+
+  const auto read = under_test.ReadInto(buffer);
+
+  EXPECT_EQ(kDefaultTestContent.size(), read);
+  VerifyContentEquals(kDefaultTestContent, {buffer.begin(), buffer.begin() + read});
+  VerifyCursorAtTheEnd(under_test);
+}
+
+TEST_F(FileTapeTest, ReadIntoBufferWithIncompleteLastValue) {
+  using Value = std::int32_t;
+  const std::vector<Value> values{1, 2, 3};
+  auto content = std::string(reinterpret_cast<const char *>(values.data()), sizeof(Value) * 3);
+  content.pop_back();
+  CreateFileWithBinaryContent(input_file_path_, content);
+  FileTape<Value, false> under_test(config_, input_file_path_);
+  std::vector<Value> buffer(values.size());
+
+  const auto read = under_test.ReadInto(buffer);
+  under_test.MoveBackward();
+
+  EXPECT_EQ(values.size() - 1, read) << "The incomplete value mustn't be read";
+  EXPECT_EQ(values[read - 1], under_test.Read())
+      << "The cursor must be after the last complete value";
+}
+
+TEST_F(FileTapeTest, WriteFromBufferToMutableFileTape) {
+  const std::string new_content = "Updated. " + kDefaultTestContent + " Updated.";
+  FileTape under_test = InitTapeWithContent<true>();
+
+  const auto written = under_test.WriteFrom(std::span(new_content.data(), new_content.size()));
+  under_test.MoveToBegin();
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  EXPECT_EQ(new_content.size(), written);
+  VerifyContentEquals(new_content, actual_content);
+}
+
+TEST_F(FileTapeTest, WriteFromBufferToImmutableFileTape) {
+  const std::string new_content = "Updated. " + kDefaultTestContent + " Updated.";
+  FileTape under_test = InitTapeWithContent<false>();
+
+  const auto written = under_test.WriteFrom(std::span(new_content.data(), new_content.size()));
+  under_test.MoveToBegin();
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  EXPECT_EQ(0, written) << "Mustn't be written to immutable tape";
+  VerifyContentEquals(kDefaultTestContent, actual_content);
+}
+
 TEST_F(FileTapeTest, ReadDelay) {
   constexpr auto read_duration = 500ms;
   config_.SetReadDuration(read_duration);
@@ -291,4 +356,25 @@ TEST_F(FileTapeTest, MoveToEndDuration) {
   EXPECT_EQ(expected_duration, actual_duration);
 }
 
+TEST_F(FileTapeTest, VirtualClockAccountsDelaysWithoutSleeping) {
+  constexpr auto read_duration = 500ms;
+  constexpr auto rewind_duration = 1s;
+  config_.SetZeroDurations();
+  config_.SetReadDuration(read_duration);
+  config_.SetRewindDuration(rewind_duration);
+  config_.SetLatencyMode(LatencyMode::kVirtualClock);
+
+  const std::string content = "aa";
+  const auto expected_duration = content.size() * read_duration + rewind_duration;
+  FileTape under_test = InitTapeWithContent(content);
+
+  const auto actual_duration = Measure<seconds>([&under_test] {
+    ReadAllFromTapeAsString(under_test);
+    under_test.MoveToBegin();
+  });
+
+  EXPECT_EQ(0s, actual_duration) << "Delays mustn't be slept in the virtual clock mode";
+  EXPECT_EQ(expected_duration, under_test.GetElapsedTime());
+}
+
 }  // namespace sot::test
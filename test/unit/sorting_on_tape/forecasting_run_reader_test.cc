@@ -0,0 +1,135 @@
+#include "forecasting_run_reader.h"
+
+#include <gtest/gtest.h>
+
+#include "loser_tree.h"
+#include "memory_tape.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using Value = std::int32_t;
+
+/**
+ * \brief Слить отсортированные массивы, читая их с лент в памяти по прогнозу.
+ */
+template <typename Comparator = std::less<Value>>
+std::vector<Value> MergeRuns(
+    std::vector<std::vector<Value>> runs, const size_t block_size, const size_t spare_count
+) {
+  std::vector<std::shared_ptr<Tape<Value>>> tapes;
+  for (auto &run : runs) {
+    std::ranges::sort(run, Comparator());
+    tapes.push_back(std::make_shared<MemoryTape<Value>>(std::move(run)));
+  }
+  core::IoExecutor io_executor(1);
+  ForecastingRunReader<Value, Comparator> readers(tapes, block_size, spare_count, &io_executor);
+  LoserTree<Value, Comparator> sources(tapes.size());
+  for (size_t i = 0; i < tapes.size(); ++i) {
+    if (!readers.IsEnd(i)) {
+      sources.Push(i, readers.Read(i));
+    }
+  }
+  sources.Build();
+
+  std::vector<Value> merged;
+  while (!sources.Empty()) {
+    merged.push_back(sources.TopValue());
+    const auto run = sources.Top();
+    if (readers.MoveForward(run)) {
+      sources.ReplaceTop(readers.Read(run));
+    } else {
+      sources.PopTop();
+    }
+  }
+  return merged;
+}
+
+/**
+ * \brief Получить ожидаемый результат слияния массивов.
+ */
+template <typename Comparator = std::less<Value>>
+std::vector<Value> Concatenate(const std::vector<std::vector<Value>> &runs) {
+  std::vector<Value> values;
+  for (const auto &run : runs) {
+    values.insert(values.end(), run.begin(), run.end());
+  }
+  std::ranges::sort(values, Comparator());
+  return values;
+}
+
+class ForecastingRunReaderTest : public testing::TestWithParam<size_t> {
+ protected:
+  core::IoExecutor io_executor_{1};
+};
+
+TEST_P(ForecastingRunReaderTest, MergeRunsOfDifferentLength) {
+  std::vector<std::vector<Value>> runs;
+  for (const size_t size : {10000, 1, 0, 5432, 20000, 7, 64}) {
+    runs.push_back(GenerateRandomArray<Value>(size));
+  }
+  const auto expected = Concatenate(runs);
+
+  for (const size_t block_size : {1, 8, 64, 1000, 30000}) {
+    VerifyContentEquals(expected, MergeRuns(runs, block_size, GetParam()));
+  }
+}
+
+TEST_P(ForecastingRunReaderTest, MergeManyRunsDesc) {
+  std::vector<std::vector<Value>> runs;
+  for (size_t i = 0; i < 150; ++i) {
+    runs.push_back(GenerateRandomArray<Value>(1000 + i));
+  }
+  const auto expected = Concatenate<std::greater<>>(runs);
+
+  VerifyContentEquals(expected, MergeRuns<std::greater<>>(runs, 100, GetParam()));
+}
+
+TEST_P(ForecastingRunReaderTest, ReadRunsByBlocks) {
+  std::vector<std::vector<Value>> runs;
+  std::vector<std::shared_ptr<Tape<Value>>> tapes;
+  for (const size_t size : {1000, 0, 77}) {
+    runs.push_back(GenerateRandomArray<Value>(size));
+    tapes.push_back(std::make_shared<MemoryTape<Value>>(runs.back()));
+  }
+  ForecastingRunReader<Value, std::less<>> readers(tapes, 10, GetParam(), &io_executor_);
+
+  for (size_t run = 0; run < runs.size(); ++run) {
+    std::vector<Value> actual;
+    for (auto has_values = !readers.IsEnd(run); has_values;) {
+      // блок читается в два приема, чтобы проверить сдвиг внутри блока
+      const auto block = readers.ReadBlock(run);
+      const auto half = block.size() / 2;
+      actual.insert(actual.end(), block.begin(), block.begin() + half);
+      ASSERT_TRUE(readers.Skip(run, half));
+      const auto rest = readers.ReadBlock(run);
+      actual.insert(actual.end(), rest.begin(), rest.end());
+      has_values = readers.Skip(run, rest.size());
+    }
+    VerifyContentEquals(runs[run], actual);
+    EXPECT_THROW(readers.Skip(run, 1), std::runtime_error);
+  }
+}
+
+TEST_P(ForecastingRunReaderTest, StopReadingEarly) {
+  std::vector<std::shared_ptr<Tape<Value>>> tapes;
+  for (size_t i = 0; i < 5; ++i) {
+    tapes.push_back(std::make_shared<MemoryTape<Value>>(GenerateRandomArray<Value>(1000)));
+  }
+  using Reader = ForecastingRunReader<Value, std::less<>>;
+  Reader readers(tapes, 10, GetParam(), &io_executor_);
+
+  EXPECT_TRUE(readers.MoveForward(0));
+  EXPECT_THROW(Reader(tapes, 0, GetParam(), &io_executor_), std::runtime_error);
+}
+
+TEST(ForecastingRunReaderWithoutExecutorTest, RequireExecutorForSpareBuffers) {
+  const std::vector<std::shared_ptr<Tape<Value>>> tapes{std::make_shared<MemoryTape<Value>>()};
+
+  EXPECT_THROW((ForecastingRunReader<Value, std::less<>>(tapes, 10, 1)), std::invalid_argument);
+  EXPECT_NO_THROW((ForecastingRunReader<Value, std::less<>>(tapes, 10, 0)));
+}
+
+INSTANTIATE_TEST_SUITE_P(SpareBuffers, ForecastingRunReaderTest, testing::Values(0, 1, 4));
+
+}  // namespace sot::test
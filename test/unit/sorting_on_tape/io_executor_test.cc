@@ -0,0 +1,35 @@
+#include "core/io_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace sot::test {
+
+TEST(IoExecutorTest, ReturnOperationResults) {
+  core::IoExecutor executor(2);
+  std::vector<std::future<size_t>> results;
+
+  for (size_t i = 0; i < 100; ++i) {
+    results.push_back(executor.Submit([i]() {
+      return i * i;
+    }));
+  }
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(i * i, results[i].get());
+  }
+}
+
+TEST(IoExecutorTest, RethrowOperationError) {
+  core::IoExecutor executor(1);
+
+  auto result = executor.Submit([]() {
+    throw std::runtime_error("Can't write to tape.");
+  });
+
+  EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+}  // namespace sot::test
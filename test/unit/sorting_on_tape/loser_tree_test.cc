@@ -0,0 +1,129 @@
+#include "loser_tree.h"
+
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+namespace sot::test {
+
+using Value = std::int32_t;
+
+/**
+ * \brief Слить отсортированные массивы с помощью дерева проигравших.
+ */
+template <typename Comparator = std::less<Value>>
+std::vector<Value> MergeWithLoserTree(const std::vector<std::vector<Value>> &runs) {
+  std::vector<size_t> positions(runs.size(), 0);
+  LoserTree<Value, Comparator> under_test(runs.size());
+  for (size_t i = 0; i < runs.size(); ++i) {
+    if (!runs[i].empty()) {
+      under_test.Push(i, runs[i].front());
+    }
+  }
+  under_test.Build();
+
+  std::vector<Value> merged;
+  while (!under_test.Empty()) {
+    const auto source = under_test.Top();
+    merged.push_back(under_test.TopValue());
+    if (++positions[source] < runs[source].size()) {
+      under_test.ReplaceTop(runs[source][positions[source]]);
+    } else {
+      under_test.PopTop();
+    }
+  }
+  return merged;
+}
+
+/**
+ * \brief Сгенерировать отсортированные массивы случайной длины.
+ * \return сгенерированные массивы и результат их слияния.
+ */
+template <typename Comparator = std::less<Value>>
+std::pair<std::vector<std::vector<Value>>, std::vector<Value>> GenerateSortedRuns(
+    const size_t run_count, const size_t max_run_size
+) {
+  std::mt19937 generator(std::random_device{}());
+  std::vector<std::vector<Value>> runs(run_count);
+  std::vector<Value> expected;
+  for (auto &run : runs) {
+    run = GenerateRandomArray<Value>(generator() % (max_run_size + 1), generator());
+    std::ranges::sort(run, Comparator());
+    expected.insert(expected.end(), run.begin(), run.end());
+  }
+  std::ranges::sort(expected, Comparator());
+  return {runs, expected};
+}
+
+TEST(LoserTreeTest, MergeRandomRuns) {
+  const auto [runs, expected] = GenerateSortedRuns(37, 1000);
+
+  const auto actual = MergeWithLoserTree(runs);
+
+  VerifyContentEquals(expected, actual);
+}
+
+TEST(LoserTreeTest, MergeRandomRunsInDescendingOrder) {
+  using Comparator = std::greater<Value>;
+  const auto [runs, expected] = GenerateSortedRuns<Comparator>(64, 1000);
+
+  const auto actual = MergeWithLoserTree<Comparator>(runs);
+
+  VerifyContentEquals(expected, actual);
+}
+
+TEST(LoserTreeTest, MergeWithEmptyRuns) {
+  const std::vector<std::vector<Value>> runs{{}, {1, 3, 5}, {}, {2, 4}, {}};
+
+  const auto actual = MergeWithLoserTree(runs);
+
+  VerifyContentEquals(std::vector<Value>{1, 2, 3, 4, 5}, actual);
+}
+
+TEST(LoserTreeTest, MergeSingleRun) {
+  const std::vector<std::vector<Value>> runs{{1, 2, 2, 7}};
+
+  const auto actual = MergeWithLoserTree(runs);
+
+  VerifyContentEquals(runs.front(), actual);
+}
+
+TEST(LoserTreeTest, GetSecondValue) {
+  const auto [runs, expected] = GenerateSortedRuns(13, 100);
+  std::vector<size_t> positions(runs.size(), 0);
+  LoserTree<Value> under_test(runs.size());
+  for (size_t i = 0; i < runs.size(); ++i) {
+    if (!runs[i].empty()) {
+      under_test.Push(i, runs[i].front());
+    }
+  }
+  under_test.Build();
+
+  // следующее значение слияния - либо следующее значение победителя, либо второе в дереве
+  for (size_t i = 0; !under_test.Empty(); ++i) {
+    const auto source = under_test.Top();
+    const auto *second = under_test.SecondValue();
+    if (i + 1 < expected.size() && positions[source] + 1 < runs[source].size() &&
+        runs[source][positions[source] + 1] == expected[i + 1]) {
+      EXPECT_TRUE(second == nullptr || expected[i + 1] <= *second);
+    } else if (i + 1 < expected.size()) {
+      ASSERT_NE(nullptr, second);
+      EXPECT_EQ(expected[i + 1], *second);
+    } else {
+      EXPECT_EQ(nullptr, second);
+    }
+    if (++positions[source] < runs[source].size()) {
+      under_test.ReplaceTop(runs[source][positions[source]]);
+    } else {
+      under_test.PopTop();
+    }
+  }
+}
+
+TEST(LoserTreeTest, MergeWithoutRuns) {
+  const auto actual = MergeWithLoserTree({});
+
+  VerifyContentEquals(std::vector<Value>{}, actual);
+}
+
+}  // namespace sot::test
@@ -0,0 +1,62 @@
+#include "core/memory_governor.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+namespace sot::test {
+
+using namespace core;
+using namespace std::chrono_literals;
+
+TEST(MemoryGovernorTest, ReserveAndRelease) {
+  MemoryGovernor governor(100);
+  {
+    auto first = governor.Reserve(60);
+    const auto second = governor.TryReserve(40);
+
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(60, first.GetSize());
+    EXPECT_EQ(0, governor.GetAvailable());
+    EXPECT_FALSE(governor.TryReserve(1).has_value());
+
+    first.Release();
+    EXPECT_EQ(60, governor.GetAvailable());
+  }
+  EXPECT_EQ(100, governor.GetAvailable());
+}
+
+TEST(MemoryGovernorTest, MovedReservationIsReleasedOnce) {
+  MemoryGovernor governor(100);
+  auto reservation = governor.Reserve(30);
+  MemoryGovernor::Reservation moved;
+  moved = std::move(reservation);
+  reservation.Release();
+
+  EXPECT_EQ(70, governor.GetAvailable());
+  moved = governor.Reserve(50);
+  EXPECT_EQ(50, governor.GetAvailable());
+}
+
+TEST(MemoryGovernorTest, ReserveWaitsForRelease) {
+  MemoryGovernor governor(100);
+  auto reservation = governor.Reserve(80);
+
+  auto waiting = std::async(std::launch::async, [&governor]() {
+    return governor.Reserve(50).GetSize();
+  });
+
+  EXPECT_EQ(std::future_status::timeout, waiting.wait_for(50ms));
+  reservation.Release();
+  EXPECT_EQ(50, waiting.get());
+  EXPECT_EQ(100, governor.GetAvailable());
+}
+
+TEST(MemoryGovernorTest, ReserveMoreThanLimit) {
+  MemoryGovernor governor(100);
+
+  EXPECT_THROW(governor.Reserve(101), std::invalid_argument);
+  EXPECT_FALSE(governor.TryReserve(101).has_value());
+}
+
+}  // namespace sot::test
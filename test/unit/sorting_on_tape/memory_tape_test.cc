@@ -0,0 +1,104 @@
+#include "memory_tape.h"
+
+#include <gtest/gtest.h>
+
+#include "fake_configuration.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+static const std::string kDefaultTestContent = "Test content";
+
+MemoryTape<char> InitTapeWithContent(const std::string &content = kDefaultTestContent) {
+  return MemoryTape<char>({content.begin(), content.end()});
+}
+
+TEST(MemoryTapeTest, ReadUntilTrue) {
+  MemoryTape under_test = InitTapeWithContent();
+
+  std::string actual_content;
+  while (const auto ch = under_test.Read()) {
+    actual_content += *ch;
+  }
+
+  VerifyContentEquals(kDefaultTestContent, actual_content);
+}
+
+TEST(MemoryTapeTest, ReadFromEmptyTape) {
+  MemoryTape under_test = InitTapeWithContent("");
+
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  VerifyContentEquals("", actual_content);
+  VerifyCursorAtTheBeginning<char>(under_test, std::nullopt);
+}
+
+TEST(MemoryTapeTest, ReadIntoBufferLargerThanContent) {
+  MemoryTape under_test = InitTapeWithContent();
+  std::vector<char> buffer(kDefaultTestContent.size() * 2);
+
+  const auto read = under_test.ReadInto(buffer);
+
+  EXPECT_EQ(kDefaultTestContent.size(), read);
+  VerifyContentEquals(kDefaultTestContent, {buffer.begin(), buffer.begin() + read});
+}
+
+TEST(MemoryTapeTest, MoveBackwardFromEnd) {
+  MemoryTape under_test = InitTapeWithContent();
+
+  under_test.MoveToEnd();
+  under_test.MoveBackward();
+  const auto last_char = under_test.Read();
+
+  EXPECT_EQ(kDefaultTestContent.back(), last_char)
+      << "After moving back, there must be the last character";
+}
+
+TEST(MemoryTapeTest, OverwriteAndAppend) {
+  const std::string new_content = "Updated. " + kDefaultTestContent + " Updated.";
+  MemoryTape under_test = InitTapeWithContent();
+
+  under_test.MoveForward();
+  const auto written = under_test.WriteN({new_content.begin(), new_content.end()});
+  under_test.MoveToBegin();
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  EXPECT_EQ(new_content.size(), written);
+  VerifyContentEquals(kDefaultTestContent.front() + new_content, actual_content);
+}
+
+TEST(MemoryTapeTest, WriteAfterMovingPastTheEnd) {
+  MemoryTape under_test = InitTapeWithContent("a");
+
+  under_test.MoveToEnd();
+  under_test.MoveForward();
+  under_test.Write('b');
+
+  VerifyContentEquals(std::vector<char>{'a', '\0', 'b'}, under_test.GetValues());
+}
+
+TEST(MemoryTapeTest, VirtualClockWithConfiguration) {
+  FakeConfiguration config;
+  config.SetZeroDurations();
+  config.SetWriteDuration(1s);
+  config.SetLatencyMode(LatencyMode::kVirtualClock);
+  MemoryTape<char> under_test(config);
+
+  under_test.WriteN({kDefaultTestContent.begin(), kDefaultTestContent.end()});
+
+  EXPECT_EQ(kDefaultTestContent.size() * 1s, under_test.GetElapsedTime());
+}
+
+TEST(MemoryTapeTest, NoLatencyWithoutConfiguration) {
+  MemoryTape under_test = InitTapeWithContent();
+
+  ReadAllFromTapeAsString(under_test);
+  under_test.MoveToBegin();
+
+  EXPECT_EQ(0us, under_test.GetElapsedTime());
+}
+
+}  // namespace sot::test
@@ -0,0 +1,27 @@
+#include "merge_buffer_layout.h"
+
+#include <gtest/gtest.h>
+
+namespace sot::test {
+
+TEST(MergeBufferLayoutTest, SplitWithAsyncIo) {
+  const MergeBufferLayout layout(16 * MergeBufferLayout::kMinAsyncIoBlockSize, 10);
+
+  // буферы серий, запасные буферы и двойной буфер записи
+  EXPECT_TRUE(layout.async_io);
+  EXPECT_EQ(1024, layout.block_size);
+  EXPECT_EQ(MergeBufferLayout::kForecastSpareBufferCount, layout.GetSpareCount());
+  EXPECT_EQ(2 * layout.block_size, layout.GetWriteBufferSize());
+}
+
+TEST(MergeBufferLayoutTest, SplitWithoutAsyncIoInSmallMemory) {
+  const MergeBufferLayout layout(1100, 10);
+
+  // без фонового ввода-вывода память делится только между сериями и буфером записи
+  EXPECT_FALSE(layout.async_io);
+  EXPECT_EQ(100, layout.block_size);
+  EXPECT_EQ(0, layout.GetSpareCount());
+  EXPECT_EQ(layout.block_size, layout.GetWriteBufferSize());
+}
+
+}  // namespace sot::test
@@ -0,0 +1,200 @@
+#include "mmap_file_tape.h"
+
+#include <gtest/gtest.h>
+
+#include "fake_configuration.h"
+#include "file_utils.h"
+#include "test_base.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+using namespace files;
+
+class MmapFileTapeTest : public TestBase, public testing::Test {
+ public:
+  static constexpr std::string kDefaultTestContent = "Test content";
+
+  path input_file_path_;
+
+  MmapFileTapeTest();
+
+  template <bool Mutable = false>
+  MmapFileTape<char, Mutable> InitTapeWithContent(const std::string &content = kDefaultTestContent);
+};
+
+MmapFileTapeTest::MmapFileTapeTest() {
+  TestBase::SetUp(
+      "MmapFileTapeTest", testing::UnitTest::GetInstance()->current_test_info()->name()
+  );
+  input_file_path_ = file_prefix_ / "file";
+}
+
+template <bool Mutable>
+MmapFileTape<char, Mutable> MmapFileTapeTest::InitTapeWithContent(const std::string &content) {
+  CreateFileWithBinaryContent(input_file_path_, content);
+  return {config_, input_file_path_};
+}
+
+TEST_F(MmapFileTapeTest, ReadFromImmutableFileTape) {
+  MmapFileTape under_test = InitTapeWithContent();
+
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  VerifyContentEquals(kDefaultTestContent, actual_content);
+  VerifyCursorAtTheEnd(under_test);
+}
+
+TEST_F(MmapFileTapeTest, ReadUntilTrue) {
+  MmapFileTape under_test = InitTapeWithContent();
+
+  std::string actual_content;
+  while (const auto ch = under_test.Read()) {
+    actual_content += *ch;
+  }
+
+  VerifyContentEquals(kDefaultTestContent, actual_content);
+  VerifyCursorAtTheEnd(under_test);
+}
+
+TEST_F(MmapFileTapeTest, ReadFromEmptyTape) {
+  const std::string content;
+  MmapFileTape under_test = InitTapeWithContent(content);
+
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  VerifyContentEquals(content, actual_content);
+  VerifyCursorAtTheEnd(under_test);
+  VerifyCursorAtTheBeginning<char>(under_test, std::nullopt);
+}
+
+TEST_F(MmapFileTapeTest, ReadIntoAndWriteEmptyFromEmptyTape) {
+  MmapFileTape under_test = InitTapeWithContent<true>("");
+  std::vector<char> buffer(4);
+
+  EXPECT_EQ(0, under_test.ReadInto(buffer));
+  EXPECT_EQ(0, under_test.WriteFrom(std::span<const char>()));
+  EXPECT_EQ(0, under_test.ReadInto(buffer));
+}
+
+TEST_F(MmapFileTapeTest, MoveForwardToReadPartOfContent) {
+  constexpr auto skip = kDefaultTestContent.size() / 2;
+  MmapFileTape under_test = InitTapeWithContent();
+
+  for (size_t i = 0; i < skip; ++i) {
+    under_test.MoveForward();
+  }
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  VerifyContentEquals(kDefaultTestContent.substr(skip), actual_content);
+}
+
+TEST_F(MmapFileTapeTest, MoveBackwardFromEnd) {
+  MmapFileTape under_test = InitTapeWithContent();
+
+  under_test.MoveToEnd();
+  under_test.MoveBackward();
+  const auto last_char = under_test.Read();
+
+  EXPECT_EQ(kDefaultTestContent.back(), last_char)
+      << "After moving back, there must be the last character";
+}
+
+TEST_F(MmapFileTapeTest, ViewPartOfContent) {
+  constexpr auto part_size = kDefaultTestContent.size() / 2;
+  MmapFileTape under_test = InitTapeWithContent();
+
+  const auto view = under_test.View(part_size);
+
+  VerifyContentEquals(kDefaultTestContent.substr(0, part_size), {view.begin(), view.end()});
+  EXPECT_EQ(kDefaultTestContent[part_size], under_test.Read())
+      << "After viewing, the cursor must be after the last viewed value";
+}
+
+TEST_F(MmapFileTapeTest, ReadIntoBufferLargerThanContent) {
+  MmapFileTape under_test = InitTapeWithContent();
+  std::vector<char> buffer(kDefaultTestContent.size() * 2);
+
+  const auto read = under_test.ReadInto(buffer);
+
+  EXPECT_EQ(kDefaultTestContent.size(), read);
+  VerifyContentEquals(kDefaultTestContent, {buffer.begin(), buffer.begin() + read});
+  VerifyCursorAtTheEnd(under_test);
+}
+
+TEST_F(MmapFileTapeTest, WriteToImmutableFileTape) {
+  const std::string new_content = "Updated. " + kDefaultTestContent + " Updated.";
+  MmapFileTape under_test = InitTapeWithContent<false>();
+
+  const auto written = under_test.WriteN({new_content.begin(), new_content.end()});
+  under_test.MoveToBegin();
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  EXPECT_EQ(0, written) << "Mustn't be written to immutable tape";
+  VerifyContentEquals(kDefaultTestContent, actual_content);
+}
+
+TEST_F(MmapFileTapeTest, AppendToMutableFileTape) {
+  const std::string appended_content = ". Appended content";
+  MmapFileTape under_test = InitTapeWithContent<true>();
+
+  under_test.MoveToEnd();
+  const auto written = under_test.WriteN({appended_content.begin(), appended_content.end()});
+  under_test.MoveToBegin();
+  const auto actual_content = ReadAllFromTapeAsString(under_test);
+
+  EXPECT_EQ(appended_content.size(), written);
+  VerifyContentEquals(kDefaultTestContent + appended_content, actual_content);
+}
+
+TEST_F(MmapFileTapeTest, GrowMutableFileTape) {
+  using Value = std::int64_t;
+  const auto written_numbers =
+      GenerateRandomArray<Value>(3 * MmapFileTape<Value>::kMinMappingSize / sizeof(Value));
+  {
+    MmapFileTape<Value, true> under_test(config_, input_file_path_);
+
+    const auto written = under_test.WriteN(written_numbers);
+    under_test.MoveToBegin();
+    const auto actual_numbers = under_test.ReadN(SIZE_MAX);
+
+    EXPECT_EQ(written_numbers.size(), written);
+    VerifyContentEquals(written_numbers, actual_numbers);
+  }
+  EXPECT_EQ(written_numbers.size() * sizeof(Value), file_size(input_file_path_))
+      << "The file must be truncated to the written content";
+}
+
+TEST_F(MmapFileTapeTest, ReadDelay) {
+  constexpr auto read_duration = 500ms;
+  config_.SetReadDuration(read_duration);
+
+  const std::string content = "aa";
+  const auto expected_duration = content.size() * read_duration;
+  MmapFileTape under_test = InitTapeWithContent(content);
+
+  const auto actual_duration = Measure<seconds>([&under_test] {
+    ReadAllFromTapeAsString(under_test);
+  });
+
+  EXPECT_EQ(expected_duration, actual_duration);
+}
+
+TEST_F(MmapFileTapeTest, WriteDelay) {
+  constexpr auto write_duration = 500ms;
+  config_.SetWriteDuration(write_duration);
+
+  const std::string content = "aa";
+  const auto expected_duration = content.size() * write_duration;
+  MmapFileTape under_test = InitTapeWithContent<true>(content);
+
+  const auto actual_duration = Measure<seconds>([&content, &under_test] {
+    under_test.WriteN({content.begin(), content.end()});
+  });
+
+  EXPECT_EQ(expected_duration, actual_duration);
+}
+
+}  // namespace sot::test
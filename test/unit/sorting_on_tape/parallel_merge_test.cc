@@ -0,0 +1,93 @@
+#include "parallel_merge.h"
+
+#include <gtest/gtest.h>
+
+#include "core/thread_pool.h"
+#include "memory_tape.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using Value = std::int32_t;
+
+/**
+ * \brief Слить отсортированные массивы, записанные на ленты в памяти.
+ */
+template <typename Comparator = std::less<Value>>
+std::vector<Value> MergeRuns(
+    const std::vector<std::vector<Value>> &runs,
+    const size_t buffer_size,
+    const size_t worker_count = 4
+) {
+  core::ThreadPool thread_pool(worker_count);
+  std::vector<std::shared_ptr<Tape<Value>>> sources;
+  for (auto run : runs) {
+    std::sort(run.begin(), run.end(), Comparator());
+    sources.push_back(std::make_shared<MemoryTape<Value>>(std::move(run)));
+  }
+  MemoryTape<Value> target;
+  ParallelMerger<Value, Comparator, core::ThreadPool>(
+      thread_pool, Comparator(), worker_count, buffer_size
+  )
+      .Merge(sources, target);
+  target.MoveToBegin();
+  return ReadAllFromTape(target);
+}
+
+/**
+ * \brief Получить ожидаемый результат слияния массивов.
+ */
+template <typename Comparator = std::less<Value>>
+std::vector<Value> Concatenate(const std::vector<std::vector<Value>> &runs) {
+  std::vector<Value> values;
+  for (const auto &run : runs) {
+    values.insert(values.end(), run.begin(), run.end());
+  }
+  std::ranges::sort(values, Comparator());
+  return values;
+}
+
+TEST(ParallelMergeTest, MergeRandomRunsOfDifferentLength) {
+  std::vector<std::vector<Value>> runs;
+  for (const size_t size : {100000, 1, 0, 54321, 200003, 7}) {
+    runs.push_back(GenerateRandomArray<Value>(size));
+  }
+  const auto expected = Concatenate(runs);
+
+  for (const size_t buffer_size : {12, 1000, 100000, 1000000}) {
+    VerifyContentEquals(expected, MergeRuns(runs, buffer_size));
+  }
+}
+
+TEST(ParallelMergeTest, MergeDescWithManyDuplicates) {
+  std::vector<std::vector<Value>> runs;
+  for (size_t i = 0; i < 5; ++i) {
+    auto run = GenerateRandomArray<Value>(30000);
+    std::ranges::transform(run, run.begin(), [](const Value value) { return value % 3; });
+    runs.push_back(std::move(run));
+  }
+  const auto expected = Concatenate<std::greater<>>(runs);
+
+  VerifyContentEquals(expected, MergeRuns<std::greater<>>(runs, 40000));
+}
+
+TEST(ParallelMergeTest, MergeWithoutFreeThreads) {
+  std::vector<std::vector<Value>> runs;
+  for (size_t i = 0; i < 3; ++i) {
+    runs.push_back(GenerateRandomArray<Value>(50000));
+  }
+  const auto expected = Concatenate(runs);
+
+  VerifyContentEquals(expected, MergeRuns(runs, 60000, 1));
+}
+
+TEST(ParallelMergeTest, MergeEmptyRuns) {
+  VerifyContentEquals({}, MergeRuns({}, 10));
+  VerifyContentEquals({}, MergeRuns({{}, {}}, 10));
+}
+
+TEST(ParallelMergeTest, TooSmallBuffer) {
+  EXPECT_THROW(MergeRuns({{1}, {2}, {3}}, 5), std::invalid_argument);
+}
+
+}  // namespace sot::test
@@ -0,0 +1,86 @@
+#include "parallel_sort.h"
+
+#include <gtest/gtest.h>
+
+#include "core/thread_pool.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using Value = std::int32_t;
+
+/**
+ * \brief Отсортировать значения параллельно с последовательной сортировкой корзин std::sort.
+ */
+template <typename Comparator = std::less<Value>>
+std::vector<Value> SampleSort(
+    std::vector<Value> values, const size_t part_count, const size_t thread_count = 4
+) {
+  core::ThreadPool thread_pool(thread_count);
+  const auto sort = [](std::span<Value> bucket, std::span<Value>) {
+    std::sort(bucket.begin(), bucket.end(), Comparator());
+  };
+  std::vector<Value> scratch(values.size());
+  ParallelSampleSorter<Value, Comparator, core::ThreadPool, decltype(sort)>(
+      thread_pool, Comparator(), sort
+  )
+      .Sort(values, scratch, part_count);
+  return values;
+}
+
+TEST(ParallelSortTest, SortRandomArray) {
+  for (const size_t part_count : {1, 2, 3, 8, 64}) {
+    const auto values = GenerateRandomArray<Value>(100003);
+    auto expected = values;
+    std::ranges::sort(expected);
+
+    VerifyContentEquals(expected, SampleSort(values, part_count));
+  }
+}
+
+TEST(ParallelSortTest, SortDescWithManyDuplicates) {
+  auto values = GenerateRandomArray<Value>(50000);
+  std::ranges::transform(values, values.begin(), [](const Value value) { return value % 3; });
+  auto expected = values;
+  std::ranges::sort(expected, std::greater<>());
+
+  VerifyContentEquals(expected, SampleSort<std::greater<>>(values, 8));
+}
+
+TEST(ParallelSortTest, SortArraySmallerThanPartCount) {
+  VerifyContentEquals({}, SampleSort({}, 8));
+  VerifyContentEquals({1}, SampleSort({1}, 8));
+  VerifyContentEquals({1, 2, 3}, SampleSort({3, 1, 2}, 8));
+}
+
+TEST(ParallelSortTest, PartsAreSortedWithoutFreeThreads) {
+  const auto values = GenerateRandomArray<Value>(10000);
+  auto expected = values;
+  std::ranges::sort(expected);
+
+  VerifyContentEquals(expected, SampleSort(values, 16, 1));
+}
+
+TEST(ParallelSortTest, ParallelForRunsEachTaskOnceAndRethrows) {
+  core::ThreadPool thread_pool(4);
+  std::vector<std::atomic_int> runs(1000);
+
+  core::ParallelFor(thread_pool, runs.size(), 4, [&runs](const size_t task) { ++runs[task]; });
+
+  EXPECT_TRUE(std::ranges::all_of(runs, [](const auto &count) { return count == 1; }));
+  EXPECT_THROW(
+      core::ParallelFor(
+          thread_pool,
+          100,
+          4,
+          [](const size_t task) {
+            if (task == 42) {
+              throw std::runtime_error("Task failed");
+            }
+          }
+      ),
+      std::runtime_error
+  );
+}
+
+}  // namespace sot::test
@@ -0,0 +1,97 @@
+#include "radix_sort.h"
+
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+namespace sot::test {
+
+/**
+ * \brief Сгенерировать случайные значения, в том числе отрицательные и повторяющиеся.
+ */
+template <typename Value>
+std::vector<Value> GenerateValues(const size_t size) {
+  if constexpr (std::is_floating_point_v<Value>) {
+    std::mt19937_64 generator(std::random_device{}());
+    std::uniform_real_distribution<Value> distribution(-1e6, 1e6);
+    std::vector<Value> values(size);
+    std::ranges::generate(values, [&]() { return distribution(generator); });
+    return values;
+  } else {
+    auto values = GenerateRandomArray<Value>(size);
+    std::ranges::copy_n(values.begin(), static_cast<std::ptrdiff_t>(size / 4), values.rbegin());
+    return values;
+  }
+}
+
+/**
+ * \brief Отсортировать значения поразрядно и сравнить результат с std::sort.
+ */
+template <typename Value, typename Comparator>
+void VerifyRadixSort(std::vector<Value> values) {
+  auto expected = values;
+  std::ranges::sort(expected, Comparator());
+  std::vector<Value> scratch(values.size());
+
+  RadixSorter<Value, Comparator>::Sort(values, scratch);
+
+  VerifyContentEquals(expected, values);
+}
+
+template <typename Value>
+class RadixSortTest : public testing::Test {};
+
+using RadixSortableTypes = testing::Types<
+    std::int8_t,
+    std::uint8_t,
+    std::int16_t,
+    std::uint32_t,
+    std::int32_t,
+    std::int64_t,
+    std::uint64_t,
+    float,
+    double>;
+TYPED_TEST_SUITE(RadixSortTest, RadixSortableTypes);
+
+TYPED_TEST(RadixSortTest, SortAsc) {
+  VerifyRadixSort<TypeParam, std::less<TypeParam>>(GenerateValues<TypeParam>(10007));
+}
+
+TYPED_TEST(RadixSortTest, SortDesc) {
+  VerifyRadixSort<TypeParam, std::greater<>>(GenerateValues<TypeParam>(10007));
+}
+
+TYPED_TEST(RadixSortTest, SortExtremeValues) {
+  using Limits = std::numeric_limits<TypeParam>;
+  std::vector<TypeParam> values = {Limits::max(), 0, Limits::lowest(), 1, Limits::min(), 0};
+  if constexpr (Limits::has_infinity) {
+    values.insert(values.end(), {Limits::infinity(), -Limits::infinity(), -1, -0.0});
+  }
+
+  VerifyRadixSort<TypeParam, std::less<>>(values);
+  VerifyRadixSort<TypeParam, std::greater<TypeParam>>(values);
+}
+
+TEST(RadixSortTest, SortEqualAndEmptyArrays) {
+  VerifyRadixSort<std::int32_t, std::less<>>(std::vector<std::int32_t>(1000, -5));
+  VerifyRadixSort<std::int32_t, std::less<>>({});
+  VerifyRadixSort<std::int32_t, std::less<>>({42});
+}
+
+TEST(RadixSortTest, ScratchBufferIsTooSmall) {
+  std::vector<std::int32_t> values = {3, 2, 1};
+  std::vector<std::int32_t> scratch(2);
+
+  EXPECT_THROW(RadixSorter<std::int32_t>::Sort(values, scratch), std::invalid_argument);
+}
+
+TEST(RadixSortTest, NotApplicableToCustomComparators) {
+  const auto comparator = [](const std::int32_t f, const std::int32_t s) { return f < s; };
+
+  EXPECT_FALSE((RadixSorter<std::int32_t, decltype(comparator)>::kApplicable));
+  EXPECT_FALSE((RadixSorter<bool>::kApplicable));
+  EXPECT_FALSE((RadixSorter<std::string>::kApplicable));
+  EXPECT_TRUE((RadixSorter<double, std::greater<double>>::kApplicable));
+}
+
+}  // namespace sot::test
@@ -0,0 +1,126 @@
+#include "core/simd_sort.h"
+
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+namespace sot::test {
+
+using namespace core;
+
+/**
+ * \brief Получить наборы инструкций, поддерживаемые процессором.
+ */
+std::vector<SimdIsa> GetSupportedIsas() {
+  std::vector<SimdIsa> isas;
+  for (const auto isa : {SimdIsa::kScalar, SimdIsa::kAvx2, SimdIsa::kAvx512}) {
+    if (isa <= GetSupportedSimdIsa()) {
+      isas.push_back(isa);
+    }
+  }
+  return isas;
+}
+
+/**
+ * \brief Сгенерировать случайные значения, в том числе отрицательные и повторяющиеся.
+ */
+template <typename Value>
+std::vector<Value> GenerateValues(const size_t size) {
+  std::vector<Value> values;
+  if constexpr (std::is_floating_point_v<Value>) {
+    std::mt19937 generator(std::random_device{}());
+    std::uniform_real_distribution<Value> distribution(-1e6, 1e6);
+    values.resize(size);
+    std::ranges::generate(values, [&]() { return distribution(generator); });
+  } else {
+    values = GenerateRandomArray<Value>(size);
+  }
+  std::ranges::copy_n(values.begin(), static_cast<std::ptrdiff_t>(size / 4), values.rbegin());
+  return values;
+}
+
+/**
+ * \brief Отсортировать значения всеми поддерживаемыми наборами инструкций и сравнить результат
+ * с std::sort.
+ */
+template <typename Value, typename Comparator>
+void VerifySimdSort(const std::vector<Value> &values) {
+  auto expected = values;
+  std::ranges::sort(expected, Comparator());
+  for (const auto isa : GetSupportedIsas()) {
+    auto actual = values;
+    std::vector<Value> scratch(values.size());
+
+    SimdSorter<Value, Comparator>::Sort(actual, scratch, isa);
+
+    VerifyContentEquals(expected, actual);
+  }
+}
+
+template <typename Value>
+class SimdSortTest : public testing::Test {};
+
+using SimdSortableTypes = testing::Types<std::int32_t, std::uint32_t, float>;
+TYPED_TEST_SUITE(SimdSortTest, SimdSortableTypes);
+
+TYPED_TEST(SimdSortTest, SortAsc) {
+  for (const size_t size : {0, 1, 7, 8, 15, 16, 17, 100, 1000, 4096, 10007}) {
+    VerifySimdSort<TypeParam, std::less<TypeParam>>(GenerateValues<TypeParam>(size));
+  }
+}
+
+TYPED_TEST(SimdSortTest, SortDesc) {
+  for (const size_t size : {0, 1, 9, 16, 31, 1000, 10007}) {
+    VerifySimdSort<TypeParam, std::greater<>>(GenerateValues<TypeParam>(size));
+  }
+}
+
+TYPED_TEST(SimdSortTest, SortExtremeValues) {
+  using Limits = std::numeric_limits<TypeParam>;
+  std::vector<TypeParam> values = {Limits::max(), 0, Limits::lowest(), 1, Limits::min(), 0};
+  if constexpr (Limits::has_infinity) {
+    values.insert(values.end(), {Limits::infinity(), -Limits::infinity(), -1});
+  }
+  values.resize(40, 1);
+
+  VerifySimdSort<TypeParam, std::less<>>(values);
+  VerifySimdSort<TypeParam, std::greater<TypeParam>>(values);
+}
+
+TEST(SimdSortTest, ResultIsBitIdenticalForAllIsas) {
+  auto values = GenerateValues<float>(1003);
+  values[10] = -0.0F;
+  values[500] = 0.0F;
+  values[900] = -0.0F;
+  std::vector<float> expected = values;
+  std::vector<float> scratch(values.size());
+  SimdSorter<float>::Sort(expected, scratch, SimdIsa::kScalar);
+
+  for (const auto isa : GetSupportedIsas()) {
+    auto actual = values;
+    SimdSorter<float>::Sort(actual, scratch, isa);
+
+    EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)));
+  }
+  const auto zero = std::ranges::find(expected, 0.0F);
+  EXPECT_TRUE(std::signbit(zero[0]) && std::signbit(zero[1]) && !std::signbit(zero[2]));
+}
+
+TEST(SimdSortTest, ScratchBufferIsTooSmall) {
+  std::vector<std::int32_t> values = {3, 2, 1};
+  std::vector<std::int32_t> scratch(2);
+
+  EXPECT_THROW(SimdSorter<std::int32_t>::Sort(values, scratch), std::invalid_argument);
+  VerifyContentEquals({3, 2, 1}, values);
+}
+
+TEST(SimdSortTest, NotApplicableToOtherTypesAndComparators) {
+  const auto comparator = [](const std::int32_t f, const std::int32_t s) { return f < s; };
+
+  EXPECT_FALSE((SimdSorter<std::int32_t, decltype(comparator)>::kApplicable));
+  EXPECT_FALSE((SimdSorter<std::int64_t>::kApplicable));
+  EXPECT_FALSE((SimdSorter<double>::kApplicable));
+  EXPECT_TRUE((SimdSorter<float, std::greater<>>::kApplicable));
+}
+
+}  // namespace sot::test
@@ -0,0 +1,149 @@
+#include "sort_cost_model.h"
+
+#include <gtest/gtest.h>
+
+#include "fake_configuration.h"
+
+namespace sot::test {
+
+class SortCostModelTest : public testing::Test {
+ public:
+  SortCostModelTest();
+
+ protected:
+  FakeConfiguration config_;
+  SortLimits limits_{
+      .values_in_memory = 1 << 20,
+      .buffer_count = 2,
+      .max_values_per_thread = 100000,
+      .max_thread_count = 8,
+      .max_merging_group_size = 50,
+  };
+};
+
+SortCostModelTest::SortCostModelTest() {
+  config_.SetReadDuration(7us);
+  config_.SetWriteDuration(7us);
+  config_.SetMoveDuration(1us);
+  config_.SetRewindDuration(1000us);
+  config_.SetGapCrossDuration(200us);
+}
+
+TEST_F(SortCostModelTest, PredictSingleBlock) {
+  const SortCostModel model(config_);
+  const SortPlan plan{.values_per_thread = 1000, .thread_count = 1, .merging_group_size = 2};
+
+  // чтение входа одной операцией, запись на выходную ленту и ее перемотка
+  EXPECT_EQ(1000 * 8us + 200us + 1000 * 8us + 200us + 1000us, model.Predict(1000, plan, limits_));
+  EXPECT_EQ(0us, model.Predict(0, plan, limits_));
+}
+
+TEST_F(SortCostModelTest, PredictMoreTimeForMoreMergePasses) {
+  const SortCostModel model(config_);
+  const SortPlan one_pass{.values_per_thread = 1000, .thread_count = 1, .merging_group_size = 50};
+  const SortPlan many_passes{.values_per_thread = 1000, .thread_count = 1, .merging_group_size = 2};
+
+  EXPECT_LT(model.Predict(32000, one_pass, limits_), model.Predict(32000, many_passes, limits_));
+}
+
+TEST_F(SortCostModelTest, PredictHuffmanFirstMerge) {
+  config_.SetReadDuration(1us);
+  config_.SetWriteDuration(1us);
+  config_.SetMoveDuration(0us);
+  config_.SetRewindDuration(0us);
+  config_.SetGapCrossDuration(0us);
+  const SortCostModel model(config_);
+  const SortPlan plan{.values_per_thread = 1000, .thread_count = 1, .merging_group_size = 4};
+
+  // 5 блоков: запись блоков, слияние двух коротких и последнее слияние четырех серий; без
+  // фонового ввода-вывода каждое слияние читает и пишет все свои значения
+  EXPECT_EQ(6000us + 2 * 2000us + 2 * 5000us, model.Predict(5000, plan, limits_));
+}
+
+TEST_F(SortCostModelTest, PredictLessTimeForLongerInitialRuns) {
+  const SortCostModel model(config_);
+  const SortPlan plan{.values_per_thread = 1000, .thread_count = 1, .merging_group_size = 2};
+  auto replacement_selection_limits = limits_;
+  replacement_selection_limits.initial_run_size = 2 * plan.values_per_thread;
+
+  EXPECT_LT(
+      model.Predict(32000, plan, replacement_selection_limits), model.Predict(32000, plan, limits_)
+  );
+}
+
+TEST_F(SortCostModelTest, ChoosePlanWithinLimits) {
+  const SortCostModel model(config_);
+
+  const auto plan = model.Choose(10000000, limits_);
+
+  EXPECT_LE(plan.values_per_thread, limits_.max_values_per_thread);
+  EXPECT_GE(plan.thread_count, 1);
+  EXPECT_LE(plan.thread_count, limits_.max_thread_count);
+  EXPECT_LE(
+      plan.thread_count * plan.values_per_thread * limits_.buffer_count, limits_.values_in_memory
+  );
+  EXPECT_GE(plan.merging_group_size, 2);
+  EXPECT_LE(plan.merging_group_size, limits_.max_merging_group_size);
+  EXPECT_EQ(model.Predict(10000000, plan, limits_), plan.predicted_time);
+}
+
+TEST_F(SortCostModelTest, ChoosePlanNotWorseThanLimits) {
+  const SortCostModel model(config_);
+  const SortPlan limits_plan{
+      .values_per_thread = limits_.max_values_per_thread,
+      .thread_count =
+          limits_.values_in_memory / (limits_.max_values_per_thread * limits_.buffer_count),
+      .merging_group_size = limits_.max_merging_group_size,
+  };
+
+  for (const size_t value_count : {1000, 1000000, 100000000}) {
+    const auto plan = model.Choose(value_count, limits_);
+
+    EXPECT_LE(plan.predicted_time, model.Predict(value_count, limits_plan, limits_));
+  }
+}
+
+TEST_F(SortCostModelTest, ChooseSmallerGroupWithSlowGapCross) {
+  limits_.max_thread_count = 1;
+  const SortCostModel fast_gap_model(config_);
+  config_.SetGapCrossDuration(0us);
+  const SortCostModel no_gap_model(config_);
+  config_.SetGapCrossDuration(1s);
+  const SortCostModel slow_gap_model(config_);
+
+  // чем дороже межблочный промежуток, тем меньше серий выгодно сливать одновременно, ведь их
+  // буферы становятся короче
+  const auto fast_gap_plan = fast_gap_model.Choose(100000000, limits_);
+  EXPECT_GE(
+      no_gap_model.Choose(100000000, limits_).merging_group_size, fast_gap_plan.merging_group_size
+  );
+  EXPECT_LE(
+      slow_gap_model.Choose(100000000, limits_).merging_group_size,
+      fast_gap_plan.merging_group_size
+  );
+}
+
+TEST_F(SortCostModelTest, ChooseSinglePassWithZeroLatencies) {
+  config_.SetReadDuration(0us);
+  config_.SetWriteDuration(0us);
+  config_.SetMoveDuration(0us);
+  config_.SetRewindDuration(0us);
+  config_.SetGapCrossDuration(0us);
+  const SortCostModel model(config_);
+
+  const auto plan = model.Choose(1000000, limits_);
+
+  // все планы бесплатны, поэтому выбирается тот, что перечитывает меньше значений
+  EXPECT_EQ(0us, plan.predicted_time);
+  const auto block_count = (1000000 + plan.values_per_thread - 1) / plan.values_per_thread;
+  EXPECT_LE(block_count, plan.merging_group_size);
+}
+
+TEST_F(SortCostModelTest, ChooseWithTooSmallMemory) {
+  const SortCostModel model(config_);
+  limits_.values_in_memory = 4;
+
+  EXPECT_THROW(static_cast<void>(model.Choose(1000, limits_)), std::invalid_argument);
+}
+
+}  // namespace sot::test
@@ -0,0 +1,92 @@
+#include "tape_block_reader.h"
+
+#include <gtest/gtest.h>
+
+#include "memory_tape.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using Value = std::int32_t;
+
+class TapeBlockReaderTest : public testing::TestWithParam<bool> {
+ protected:
+  core::IoExecutor io_executor_{2};
+
+  /**
+   * \brief Получить потоки упреждающего чтения, если оно проверяется.
+   */
+  core::IoExecutor *GetIoExecutor() {
+    return GetParam() ? &io_executor_ : nullptr;
+  }
+  /**
+   * \brief Прочитать все значения ленты читателем заданной емкости.
+   */
+  std::vector<Value> ReadAll(const std::vector<Value> &values, const size_t capacity) {
+    const auto tape = std::make_shared<MemoryTape<Value>>(values);
+    TapeBlockReader<Value> reader(capacity, tape, GetIoExecutor());
+    std::vector<Value> actual;
+    for (auto has_value = !reader.IsEnd(); has_value; has_value = reader.MoveForward()) {
+      actual.push_back(reader.Read());
+    }
+    EXPECT_TRUE(reader.IsEnd());
+    return actual;
+  }
+};
+
+TEST_P(TapeBlockReaderTest, ReadAllValues) {
+  const auto values = GenerateRandomArray<Value>(10000);
+
+  for (const size_t capacity : {1, 2, 3, 100, 5000, 10000, 20000, 30000}) {
+    VerifyContentEquals(values, ReadAll(values, capacity));
+  }
+}
+
+TEST_P(TapeBlockReaderTest, ReadAllBlocks) {
+  const auto values = GenerateRandomArray<Value>(10000);
+
+  for (const size_t capacity : {1, 2, 3, 100, 20000}) {
+    const auto tape = std::make_shared<MemoryTape<Value>>(values);
+    TapeBlockReader<Value> reader(capacity, tape, GetIoExecutor());
+    // первое значение читается поэлементно, а остаток блока - целиком
+    std::vector<Value> actual{reader.Read()};
+    reader.MoveForward();
+    for (auto has_values = !reader.IsEnd(); has_values; has_values = reader.MoveToNextBlock()) {
+      const auto block = reader.ReadBlock();
+      actual.insert(actual.end(), block.begin(), block.end());
+    }
+
+    EXPECT_TRUE(reader.ReadBlock().empty());
+    EXPECT_FALSE(reader.MoveToNextBlock());
+    VerifyContentEquals(values, actual);
+  }
+}
+
+TEST_P(TapeBlockReaderTest, ReadEmptyTape) {
+  VerifyContentEquals({}, ReadAll({}, 10));
+  EXPECT_THROW(ReadAll({}, 0), std::runtime_error);
+}
+
+TEST_P(TapeBlockReaderTest, MoveReaderWhileReading) {
+  const auto values = GenerateRandomArray<Value>(1000);
+  auto tape = std::make_shared<MemoryTape<Value>>(values);
+  TapeBlockReader<Value> reader(10, tape, GetIoExecutor());
+  std::vector<Value> actual;
+  for (size_t i = 0; i < 7; ++i) {
+    actual.push_back(reader.Read());
+    reader.MoveForward();
+  }
+
+  auto moved = std::move(reader);
+  TapeBlockReader<Value> other(4, std::make_shared<MemoryTape<Value>>(values), GetIoExecutor());
+  other = std::move(moved);
+  for (auto has_value = true; has_value; has_value = other.MoveForward()) {
+    actual.push_back(other.Read());
+  }
+
+  VerifyContentEquals(values, actual);
+}
+
+INSTANTIATE_TEST_SUITE_P(Prefetch, TapeBlockReaderTest, testing::Bool());
+
+}  // namespace sot::test
@@ -0,0 +1,135 @@
+#include "tape_block_writer.h"
+
+#include <gtest/gtest.h>
+
+#include "memory_tape.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using Value = std::int32_t;
+
+/**
+ * \brief Лента в памяти, блочная запись на которую всегда завершается неудачей.
+ */
+class FailingWriteTape : public MemoryTape<Value> {
+ public:
+  size_t WriteFrom(std::span<const Value>) override {
+    return 0;
+  }
+};
+
+class TapeBlockWriterTest : public testing::TestWithParam<bool> {
+ protected:
+  core::IoExecutor io_executor_{1};
+
+  /**
+   * \brief Получить потоки отложенной записи, если она проверяется.
+   */
+  core::IoExecutor *GetIoExecutor() {
+    return GetParam() ? &io_executor_ : nullptr;
+  }
+};
+
+TEST_P(TapeBlockWriterTest, WriteAllValues) {
+  const auto values = GenerateRandomArray<Value>(10000);
+
+  for (const size_t capacity : {1, 2, 3, 100, 5000, 10000, 30000}) {
+    const auto tape = std::make_shared<MemoryTape<Value>>();
+    TapeBlockWriter<Value> writer(capacity, tape, GetIoExecutor());
+    for (const auto value : values) {
+      writer.Write(value);
+    }
+    writer.Flush();
+    tape->MoveToBegin();
+
+    VerifyContentEquals(values, ReadAllFromTape(*tape));
+  }
+}
+
+TEST_P(TapeBlockWriterTest, WriteValuesInChunks) {
+  const auto values = GenerateRandomArray<Value>(10000);
+
+  for (const size_t capacity : {1, 3, 100, 30000}) {
+    const auto tape = std::make_shared<MemoryTape<Value>>();
+    TapeBlockWriter<Value> writer(capacity, tape, GetIoExecutor());
+    std::span<const Value> left = values;
+    for (size_t chunk = 0; !left.empty(); chunk = chunk * 2 + 1) {
+      const auto count = std::min(chunk, left.size());
+      writer.WriteFrom(left.first(count));
+      left = left.subspan(count);
+    }
+    writer.Flush();
+    tape->MoveToBegin();
+
+    VerifyContentEquals(values, ReadAllFromTape(*tape));
+  }
+}
+
+TEST_P(TapeBlockWriterTest, DestructorFlushesValues) {
+  const auto values = GenerateRandomArray<Value>(1001);
+  const auto tape = std::make_shared<MemoryTape<Value>>();
+  {
+    TapeBlockWriter<Value> writer(10, tape, GetIoExecutor());
+    for (const auto value : values) {
+      writer.Write(value);
+    }
+    auto moved = std::move(writer);
+  }
+  tape->MoveToBegin();
+
+  VerifyContentEquals(values, ReadAllFromTape(*tape));
+}
+
+TEST_P(TapeBlockWriterTest, MoveAssignmentFlushesPendingValues) {
+  const auto values = GenerateRandomArray<Value>(1001);
+  const auto other_values = GenerateRandomArray<Value>(1001);
+  const auto tape = std::make_shared<MemoryTape<Value>>();
+  const auto other_tape = std::make_shared<MemoryTape<Value>>();
+  {
+    TapeBlockWriter<Value> writer(10, tape, GetIoExecutor());
+    TapeBlockWriter<Value> other(10, other_tape, GetIoExecutor());
+    // последний полный блок каждого писателя еще может записываться в фоне
+    for (size_t i = 0; i < values.size(); ++i) {
+      writer.Write(values[i]);
+      other.Write(other_values[i]);
+    }
+
+    writer = std::move(other);
+    tape->MoveToBegin();
+    VerifyContentEquals(values, ReadAllFromTape(*tape));
+  }
+  other_tape->MoveToBegin();
+
+  VerifyContentEquals(other_values, ReadAllFromTape(*other_tape));
+}
+
+TEST_P(TapeBlockWriterTest, MoveAssignmentReportsWriteError) {
+  TapeBlockWriter<Value> writer(4, std::make_shared<FailingWriteTape>(), GetIoExecutor());
+  writer.Write(1);
+  writer.Write(2);
+
+  EXPECT_THROW(
+      writer = TapeBlockWriter<Value>(4, std::make_shared<MemoryTape<Value>>(), GetIoExecutor()),
+      std::runtime_error
+  );
+}
+
+TEST_P(TapeBlockWriterTest, FlushReportsWriteError) {
+  TapeBlockWriter<Value> writer(4, std::make_shared<FailingWriteTape>(), GetIoExecutor());
+  writer.Write(1);
+  writer.Write(2);
+
+  EXPECT_THROW(writer.Flush(), std::runtime_error);
+}
+
+TEST_P(TapeBlockWriterTest, DestructorDoesNotThrowWriteError) {
+  EXPECT_NO_THROW({
+    TapeBlockWriter<Value> writer(4, std::make_shared<FailingWriteTape>(), GetIoExecutor());
+    writer.Write(1);
+  });
+}
+
+INSTANTIATE_TEST_SUITE_P(WriteBehind, TapeBlockWriterTest, testing::Bool());
+
+}  // namespace sot::test
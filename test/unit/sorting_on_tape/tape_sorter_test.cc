@@ -2,8 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <numeric>
+#include <thread>
+
 #include "fake_configuration.h"
 #include "file_utils.h"
+#include "memory_temp_tape_provider.h"
 #include "tape_sorter_test_base.h"
 #include "test_utils.h"
 
@@ -11,6 +16,218 @@ namespace sot::test {
 
 using Value = char;
 
+/**
+ * \brief Провайдер временных файловых лент, запись на которые выполняется медленнее, чем чтение
+ * входа.
+ */
+template <typename TapeValue>
+class SlowWriteTapeProvider : public TempTapeProvider<TapeValue> {
+ public:
+  /**
+   * \brief Лента, каждая блочная запись на которую дополнительно занимает заданное время.
+   */
+  class SlowWriteTape : public Tape<TapeValue> {
+   public:
+    using Values = typename Tape<TapeValue>::Values;
+    using ValuesConstIterator = typename Tape<TapeValue>::ValuesConstIterator;
+
+    SlowWriteTape(std::unique_ptr<Tape<TapeValue>> tape, const std::chrono::milliseconds delay)
+        : tape_(std::move(tape)), delay_(delay) {
+    }
+
+    std::optional<TapeValue> Read() override {
+      return tape_->Read();
+    }
+    Values ReadN(const size_t n) override {
+      return tape_->ReadN(n);
+    }
+    size_t ReadInto(std::span<TapeValue> values) override {
+      return tape_->ReadInto(values);
+    }
+    bool Write(const TapeValue &value) override {
+      return tape_->Write(value);
+    }
+    size_t WriteN(const Values &values) override {
+      return WriteFrom(values);
+    }
+    ValuesConstIterator WriteN(ValuesConstIterator begin, ValuesConstIterator end) override {
+      return begin + static_cast<std::ptrdiff_t>(WriteFrom({begin, end}));
+    }
+    size_t WriteFrom(std::span<const TapeValue> values) override {
+      std::this_thread::sleep_for(delay_);
+      return tape_->WriteFrom(values);
+    }
+    bool MoveForward() override {
+      return tape_->MoveForward();
+    }
+    bool MoveBackward() override {
+      return tape_->MoveBackward();
+    }
+    void MoveToBegin() override {
+      tape_->MoveToBegin();
+    }
+    void MoveToEnd() override {
+      tape_->MoveToEnd();
+    }
+    [[nodiscard]] std::chrono::microseconds GetElapsedTime() const override {
+      return tape_->GetElapsedTime();
+    }
+
+   private:
+    std::unique_ptr<Tape<TapeValue>> tape_;
+    const std::chrono::milliseconds delay_;
+  };
+
+  SlowWriteTapeProvider(const Configuration &config, const std::chrono::milliseconds delay)
+      : provider_(config), delay_(delay) {
+  }
+
+  [[nodiscard]] std::unique_ptr<Tape<TapeValue>> Get() const override {
+    return std::make_unique<SlowWriteTape>(provider_.Get(), delay_);
+  }
+  [[nodiscard]] size_t GetBufferSize() const override {
+    return provider_.GetBufferSize();
+  }
+
+ private:
+  TempFileTapeProvider<TapeValue> provider_;
+  const std::chrono::milliseconds delay_;
+};
+
+/**
+ * \brief Провайдер временных файловых лент, который считает созданные и одновременно существующие
+ * ленты и сообщает заданный объем их буферов.
+ */
+template <typename TapeValue>
+class CountingTapeProvider : public TempTapeProvider<TapeValue> {
+ public:
+  /**
+   * \brief Лента, которая при уничтожении уменьшает счетчик существующих лент.
+   */
+  class CountedTape : public SlowWriteTapeProvider<TapeValue>::SlowWriteTape {
+   public:
+    CountedTape(std::unique_ptr<Tape<TapeValue>> tape, std::atomic_size_t &count)
+        : SlowWriteTapeProvider<TapeValue>::SlowWriteTape(std::move(tape), 0ms), count_(count) {
+    }
+    ~CountedTape() override {
+      --count_;
+    }
+
+   private:
+    std::atomic_size_t &count_;
+  };
+
+  CountingTapeProvider(const Configuration &config, const size_t buffer_size)
+      : provider_(config), buffer_size_(buffer_size) {
+  }
+
+  [[nodiscard]] std::unique_ptr<Tape<TapeValue>> Get() const override {
+    ++total_count_;
+    const auto count = ++count_;
+    for (auto max = max_count_.load(); count > max;) {
+      max_count_.compare_exchange_weak(max, count);
+    }
+    return std::make_unique<CountedTape>(provider_.Get(), count_);
+  }
+  [[nodiscard]] size_t GetBufferSize() const override {
+    return buffer_size_;
+  }
+  /**
+   * \brief Получить наибольшее количество одновременно существовавших лент.
+   */
+  [[nodiscard]] size_t GetMaxCount() const {
+    return max_count_;
+  }
+  /**
+   * \brief Получить количество созданных лент.
+   */
+  [[nodiscard]] size_t GetTotalCount() const {
+    return total_count_;
+  }
+
+ private:
+  TempFileTapeProvider<TapeValue> provider_;
+  const size_t buffer_size_;
+  mutable std::atomic_size_t count_ = 0;
+  mutable std::atomic_size_t max_count_ = 0;
+  mutable std::atomic_size_t total_count_ = 0;
+};
+
+/**
+ * \brief Провайдер временных файловых лент, который считает объем данных, записанных на
+ * существующие ленты, то есть занятое ими место на диске.
+ */
+template <typename TapeValue>
+class DiskUsageTapeProvider : public TempTapeProvider<TapeValue> {
+ public:
+  /**
+   * \brief Лента, которая учитывает записанные на нее данные, пока существует.
+   */
+  class MeasuredTape : public SlowWriteTapeProvider<TapeValue>::SlowWriteTape {
+   public:
+    MeasuredTape(std::unique_ptr<Tape<TapeValue>> tape, const DiskUsageTapeProvider &provider)
+        : SlowWriteTapeProvider<TapeValue>::SlowWriteTape(std::move(tape), 0ms),
+          provider_(provider) {
+    }
+    ~MeasuredTape() override {
+      provider_.usage_ -= written_;
+    }
+
+    bool Write(const TapeValue &value) override {
+      Add(1);
+      return SlowWriteTapeProvider<TapeValue>::SlowWriteTape::Write(value);
+    }
+    size_t WriteFrom(std::span<const TapeValue> values) override {
+      Add(values.size());
+      return SlowWriteTapeProvider<TapeValue>::SlowWriteTape::WriteFrom(values);
+    }
+
+   private:
+    const DiskUsageTapeProvider &provider_;
+    /// Объем записанных данных в байтах, перезапись тоже учитывается, поэтому он не меньше
+    /// размера файла.
+    size_t written_ = 0;
+
+    void Add(const size_t count) {
+      const auto size = count * sizeof(TapeValue);
+      written_ += size;
+      provider_.total_ += size;
+      const auto usage = provider_.usage_ += size;
+      for (auto peak = provider_.peak_usage_.load(); usage > peak;) {
+        provider_.peak_usage_.compare_exchange_weak(peak, usage);
+      }
+    }
+  };
+
+  explicit DiskUsageTapeProvider(const Configuration &config) : provider_(config) {
+  }
+
+  [[nodiscard]] std::unique_ptr<Tape<TapeValue>> Get() const override {
+    return std::make_unique<MeasuredTape>(provider_.Get(), *this);
+  }
+  [[nodiscard]] size_t GetBufferSize() const override {
+    return provider_.GetBufferSize();
+  }
+  /**
+   * \brief Получить наибольший объем данных в байтах, одновременно хранившихся на лентах.
+   */
+  [[nodiscard]] size_t GetPeakUsage() const {
+    return peak_usage_;
+  }
+  /**
+   * \brief Получить объем данных в байтах, записанных на все ленты.
+   */
+  [[nodiscard]] size_t GetTotalWritten() const {
+    return total_;
+  }
+
+ private:
+  TempFileTapeProvider<TapeValue> provider_;
+  mutable std::atomic_size_t usage_ = 0;
+  mutable std::atomic_size_t peak_usage_ = 0;
+  mutable std::atomic_size_t total_ = 0;
+};
+
 class TapeSorterTest : public TapeSorterTestBase<Value>, public testing::Test {
  public:
   TapeSorterTest();
@@ -89,6 +306,526 @@ TEST_F(TapeSorterTest, SortSortedInReverseOrderArray) {
   VerifyContentEquals(expected_values, actual_values);
 }
 
+TEST_F(TapeSorterTest, SortRandomArrayWithReplacementSelection) {
+  constexpr size_t value_count = 400000;
+  constexpr size_t memory_limit = value_count * sizeof(Value) / 10;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMemoryLimit(memory_limit);
+  // все серии сливаются сразу, поэтому временных лент создается столько же, сколько серий
+  config_.SetMaxMergingGroupSize(20);
+
+  std::map<RunFormationMode, size_t> tape_counts;
+  for (const auto mode :
+       {RunFormationMode::kFixedBlocks, RunFormationMode::kReplacementSelection}) {
+    config_.SetRunFormationMode(mode);
+    const auto provider = std::make_shared<CountingTapeProvider<Value>>(config_, 256);
+    tape_provider_ = provider;
+
+    const auto actual_values = SortTape();
+
+    VerifyContentEquals(expected_values, actual_values);
+    tape_counts[mode] = provider->GetTotalCount();
+  }
+  // на случайном входе серии в среднем вдвое длиннее кучи, поэтому длиннее всей памяти, которой
+  // куча меньше
+  const auto run_count = tape_counts[RunFormationMode::kReplacementSelection];
+  EXPECT_LE(run_count, value_count * sizeof(Value) / memory_limit);
+  EXPECT_LT(2 * run_count, tape_counts[RunFormationMode::kFixedBlocks]);
+}
+
+TEST_F(TapeSorterTest, SortRandomArrayDescWithReplacementSelection) {
+  using Comparator = std::greater<Value>;
+  constexpr auto value_count = 100000;
+  const auto expected_values = InitInputDataWithRandomValues<Comparator>(value_count);
+  config_.SetMemoryLimit(value_count * sizeof(Value) / 100);
+  config_.SetRunFormationMode(RunFormationMode::kReplacementSelection);
+
+  const auto actual_values = SortTape<Comparator>();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, SortSortedInReverseOrderArrayWithReplacementSelection) {
+  auto expected_values = GenerateRandomArray<Value>(100000);
+  std::ranges::sort(expected_values, std::greater());
+  CreateFileWithBinaryContent(input_file_path_, expected_values);
+  std::ranges::reverse(expected_values);
+  config_.SetMemoryLimit(expected_values.size() * sizeof(Value) / 100);
+  config_.SetRunFormationMode(RunFormationMode::kReplacementSelection);
+
+  const auto actual_values = SortTape();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, WriteInputFillingHeapStraightToOutputWithReplacementSelection) {
+  config_.SetMemoryLimit(16_KiB);
+  config_.SetRunFormationMode(RunFormationMode::kReplacementSelection);
+  // вход из value_count - 1 единиц и нуля: пока вход умещается в кучу, временные ленты не нужны, а
+  // ноль, не поместившийся в кучу, открывает вторую серию
+  const auto sort = [this](const size_t value_count) {
+    std::vector<Value> values(value_count, 1);
+    values.back() = 0;
+    CreateFileWithBinaryContent(input_file_path_, values);
+    // выход предыдущей, более длинной сортировки не должен оставить хвост
+    std::filesystem::remove(output_file_path_);
+    const auto provider = std::make_shared<CountingTapeProvider<Value>>(config_, 256);
+    tape_provider_ = provider;
+
+    const auto actual_values = SortTape();
+
+    std::ranges::sort(values);
+    VerifyContentEquals(values, actual_values);
+    return provider->GetTotalCount();
+  };
+
+  // наибольший вход, для которого не создается временных лент, равен емкости кучи
+  size_t heap_capacity = 1;
+  size_t first_spilling = 16_KiB;
+  ASSERT_GT(sort(first_spilling), 0);
+  while (first_spilling - heap_capacity > 1) {
+    const auto middle = std::midpoint(heap_capacity, first_spilling);
+    (sort(middle) == 0 ? heap_capacity : first_spilling) = middle;
+  }
+  // вход ровно из heap_capacity значений записан сразу на выходную ленту, а следующее значение
+  // образует вторую серию
+  EXPECT_EQ(sort(heap_capacity), 0);
+  EXPECT_EQ(sort(first_spilling), 2);
+}
+
+TEST_F(TapeSorterTest, SortRandomArrayWithNaturalRuns) {
+  constexpr auto value_count = 100000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMemoryLimit(value_count * sizeof(Value) / 100);
+  config_.SetRunFormationMode(RunFormationMode::kNaturalRuns);
+
+  const auto actual_values = SortTape();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, CopySortedArrayWithNaturalRuns) {
+  constexpr auto value_count = 100000;
+  auto expected_values = GenerateRandomArray<Value>(value_count);
+  std::ranges::sort(expected_values);
+  CreateFileWithBinaryContent(input_file_path_, expected_values);
+  config_.SetRunFormationMode(RunFormationMode::kNaturalRuns);
+
+  const auto [statistics, actual_values] = SortTapeOnVirtualClock();
+
+  VerifyContentEquals(expected_values, actual_values);
+  // серия продолжается через границы блоков, поэтому вход только копируется на выходную ленту
+  EXPECT_LT(statistics.device_time, 3 * value_count * 1s);
+}
+
+TEST_F(TapeSorterTest, SortSortedInReverseOrderArrayWithNaturalRuns) {
+  auto expected_values = GenerateRandomArray<Value>(100000);
+  std::ranges::sort(expected_values, std::greater());
+  CreateFileWithBinaryContent(input_file_path_, expected_values);
+  std::ranges::reverse(expected_values);
+  config_.SetRunFormationMode(RunFormationMode::kNaturalRuns);
+
+  const auto actual_values = SortTape();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, SortSortedArrayWithRandomTailWithNaturalRuns) {
+  config_.SetRunFormationMode(RunFormationMode::kNaturalRuns);
+  // с длинным хвостом до последнего слияния выполняются промежуточные, а выходная лента второй
+  // итерации уже содержит более длинный результат первой
+  for (const size_t tail_size : {25000, 250000}) {
+    auto input_values = GenerateRandomArray<Value>(100000);
+    std::ranges::sort(input_values);
+    const auto tail = GenerateRandomArray<Value>(tail_size);
+    input_values.insert(input_values.end(), tail.begin(), tail.end());
+    CreateFileWithBinaryContent(input_file_path_, input_values);
+    std::ranges::sort(input_values);
+
+    const auto actual_values = SortTape();
+
+    VerifyContentEquals(input_values, actual_values);
+  }
+}
+
+TEST_F(TapeSorterTest, KeepNaturalRunPrefixOnOutputTape) {
+  constexpr size_t prefix_size = 100000;
+  constexpr size_t tail_size = 25000;
+  // к отсортированным заглавным буквам дописаны случайные строчные, поэтому почти вся первая
+  // серия уже стоит на своем месте в результате
+  auto input_values = GenerateRandomArray<Value>(prefix_size + tail_size);
+  std::ranges::sort(input_values.begin(), input_values.begin() + prefix_size);
+  for (auto &value : std::span(input_values).subspan(prefix_size)) {
+    value = static_cast<Value>(value - 'A' + 'a');
+  }
+  CreateFileWithBinaryContent(input_file_path_, input_values);
+  std::ranges::sort(input_values);
+  config_.SetRunFormationMode(RunFormationMode::kNaturalRuns);
+
+  const auto [statistics, actual_values] = SortTapeOnVirtualClock();
+
+  VerifyContentEquals(input_values, actual_values);
+  // вход читается, первая серия пишется на выходную ленту, а хвост - на временные ленты и затем
+  // сливается; перенос первой серии целиком добавил бы еще три прохода по ней
+  EXPECT_LT(statistics.device_time, (3 * prefix_size + 4 * tail_size) * 1s);
+}
+
+TEST_F(TapeSorterTest, SortRandomArrayWithDirectIoTempTapes) {
+  constexpr auto value_count = 100000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  // буферов чанков временных лент должно хватать хотя бы на слияние двух серий
+  config_.SetMemoryLimit(value_count * sizeof(Value));
+  config_.SetTempTapeDirectIo(true);
+  config_.SetDirectIoChunkSize(4_KiB);
+  config_.SetDirectIoQueueDepth(2);
+  tape_provider_ = std::make_shared<TempFileTapeProvider<Value>>(config_);
+
+  const auto actual_values = SortTape();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, KeepTempTapeBuffersWithinMemoryLimit) {
+  constexpr size_t value_count = 100000;
+  constexpr size_t memory_limit = value_count * sizeof(Value) / 10;
+  constexpr size_t tape_buffer_size = 1_KiB;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMemoryLimit(memory_limit);
+  // провайдер сообщает настоящий размер буферов лент
+  config_.SetFileBufferSize(tape_buffer_size);
+
+  for (const auto mode :
+       {RunFormationMode::kFixedBlocks,
+        RunFormationMode::kReplacementSelection,
+        RunFormationMode::kNaturalRuns}) {
+    config_.SetRunFormationMode(mode);
+    const auto provider = std::make_shared<CountingTapeProvider<Value>>(config_, tape_buffer_size);
+    tape_provider_ = provider;
+
+    const auto actual_values = SortTape();
+
+    VerifyContentEquals(expected_values, actual_values);
+    // без слияний во время формирования лент было бы столько же, сколько серий, то есть десятки
+    EXPECT_LE(provider->GetMaxCount() * tape_buffer_size, memory_limit)
+        << "Run formation mode " << static_cast<int>(mode);
+  }
+}
+
+TEST_F(TapeSorterTest, KeepTempDiskUsageWithinTwiceInput) {
+  constexpr size_t value_count = 100000;
+  constexpr size_t input_size = value_count * sizeof(Value);
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  // сотни серий сливаются в несколько проходов
+  config_.SetMemoryLimit(input_size / 100);
+  config_.SetMaxMergingGroupSize(4);
+
+  for (const auto mode :
+       {RunFormationMode::kFixedBlocks,
+        RunFormationMode::kReplacementSelection,
+        RunFormationMode::kNaturalRuns}) {
+    config_.SetRunFormationMode(mode);
+    const auto provider = std::make_shared<DiskUsageTapeProvider<Value>>(config_);
+    tape_provider_ = provider;
+
+    const auto actual_values = SortTape();
+
+    VerifyContentEquals(expected_values, actual_values);
+    // ленты слитых серий освобождаются сразу, поэтому на диске одновременно хранятся только
+    // серии входа и результат сливающего их прохода
+    EXPECT_LT(2 * input_size, provider->GetTotalWritten())
+        << "Run formation mode " << static_cast<int>(mode);
+    EXPECT_LE(provider->GetPeakUsage(), 2 * input_size)
+        << "Run formation mode " << static_cast<int>(mode);
+  }
+}
+
+TEST_F(TapeSorterTest, SortRandomArrayWithMemoryTempTapes) {
+  constexpr auto value_count = 100000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMemoryLimit(value_count * sizeof(Value) / 100);
+  tape_provider_ = std::make_shared<MemoryTempTapeProvider<Value>>();
+
+  const auto actual_values = SortTape();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, SortWithVirtualClock) {
+  constexpr auto value_count = 100000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMemoryLimit(value_count * sizeof(Value) / 100);
+
+  const auto [statistics, actual_values] = SortTapeOnVirtualClock();
+
+  VerifyContentEquals(expected_values, actual_values);
+  // каждое значение хотя бы раз читается с входной ленты и записывается на выходную
+  EXPECT_LE(2 * value_count * 1s, statistics.critical_path);
+  EXPECT_LE(statistics.critical_path, statistics.device_time);
+}
+
+TEST_F(TapeSorterTest, WriteSingleRunStraightToOutput) {
+  constexpr auto value_count = 1000;
+  for (const auto mode : {
+           RunFormationMode::kFixedBlocks,
+           RunFormationMode::kReplacementSelection,
+       }) {
+    const auto expected_values = InitInputDataWithRandomValues(value_count);
+    config_.SetRunFormationMode(mode);
+
+    const auto [statistics, actual_values] = SortTapeOnVirtualClock();
+
+    VerifyContentEquals(expected_values, actual_values);
+    // каждое значение читается с входной ленты и записывается на выходную ровно один раз
+    EXPECT_LT(statistics.device_time, 3 * value_count * 1s);
+  }
+}
+
+TEST_F(TapeSorterTest, SortSingleBlockInParallel) {
+  constexpr auto value_count = 300000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMaxValueCountPerThread(value_count);
+  config_.SetMaxThreadCount(4);
+
+  const auto actual_values = SortTape();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, SortFewBlocksInParallelWithCustomComparator) {
+  /// Компаратор, для которого недоступна поразрядная сортировка.
+  struct Comparator {
+    bool operator()(const Value f, const Value s) const {
+      return f > s;
+    }
+  };
+  constexpr auto value_count = 300000;
+  const auto expected_values = InitInputDataWithRandomValues<Comparator>(value_count);
+  config_.SetMaxValueCountPerThread(value_count / 2);
+  config_.SetMaxThreadCount(4);
+
+  const auto actual_values = SortTape<Comparator>();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, KeepFullBlocksWithoutParallelBlockSort) {
+  /// Компаратор, для которого недоступна поразрядная сортировка.
+  struct Comparator {
+    bool operator()(const Value f, const Value s) const {
+      return f > s;
+    }
+  };
+  constexpr size_t value_count = 100000;
+  constexpr size_t max_value_count_per_thread = 10000;
+  const auto expected_values = InitInputDataWithRandomValues<Comparator>(value_count);
+  // блоки слишком коротки, чтобы делить их между потоками, поэтому вспомогательный буфер не нужен
+  // и блок целиком занимает почти всю память
+  config_.SetMaxValueCountPerThread(max_value_count_per_thread);
+  config_.SetMaxThreadCount(4);
+  config_.SetMemoryLimit(20000);
+  const auto provider = std::make_shared<CountingTapeProvider<Value>>(config_, 256);
+  tape_provider_ = provider;
+
+  const auto actual_values = SortTape<Comparator>();
+
+  VerifyContentEquals(expected_values, actual_values);
+  // по ленте на каждый блок наибольшей длины и ни одного промежуточного слияния
+  EXPECT_EQ(value_count / max_value_count_per_thread, provider->GetTotalCount());
+}
+
+TEST_F(TapeSorterTest, SortManyRunsWithParallelFinalMerge) {
+  constexpr auto value_count = 300000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMaxValueCountPerThread(value_count / 30);
+  config_.SetMaxThreadCount(4);
+
+  const auto [statistics, actual_values] = SortTapeOnVirtualClock();
+
+  VerifyContentEquals(expected_values, actual_values);
+  EXPECT_LE(statistics.critical_path, statistics.device_time);
+}
+
+TEST_F(TapeSorterTest, MergeUnevenRunCountByPlan) {
+  constexpr size_t block_size = 10000;
+  constexpr size_t block_count = 12;
+  const auto expected_values = InitInputDataWithRandomValues(block_size * block_count);
+  config_.SetMaxValueCountPerThread(block_size);
+  config_.SetMaxMergingGroupSize(4);
+  config_.SetMaxThreadCount(2);
+
+  const auto [statistics, actual_values] = SortTapeOnVirtualClock();
+
+  VerifyContentEquals(expected_values, actual_values);
+  // 12 блоков сливаются группами из 3, 4 и 4 блоков, а затем 4 серии сливаются в итоговую, поэтому
+  // при слиянии переносятся 23 блока, а не 24, как при слиянии первых блоков очереди по 4
+  constexpr auto moved_blocks = block_count + 23;
+  EXPECT_EQ(2 * moved_blocks * block_size * 1s, statistics.device_time);
+}
+
+TEST_F(TapeSorterTest, SortWithAutoTune) {
+  constexpr size_t value_count = 200000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMemoryLimit(64_KiB);
+  config_.SetMaxThreadCount(4);
+  config_.SetAutoTune(true);
+
+  const auto [statistics, actual_values] = SortTapeOnVirtualClock(value_count);
+
+  VerifyContentEquals(expected_values, actual_values);
+  ASSERT_TRUE(statistics.plan.has_value());
+  EXPECT_LE(statistics.plan->merging_group_size, 10);
+  EXPECT_LE(statistics.plan->thread_count, 4);
+  // модель не учитывает конвейер слияний и неравные серии, поэтому совпадение лишь приближенное
+  EXPECT_LE(statistics.critical_path, 2 * statistics.plan->predicted_time);
+  EXPECT_LE(statistics.plan->predicted_time, 2 * statistics.critical_path);
+}
+
+TEST_F(TapeSorterTest, SortWithAutoTuneAndMergingGroupLargerThanBlock) {
+  constexpr size_t value_count = 20000;
+  constexpr size_t block_size = 1000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMaxValueCountPerThread(block_size);
+  config_.SetMaxMergingGroupSize(block_size);
+  // без автонастройки группа из block_size блоков не сливается в одном потоке
+  ASSERT_THROW(SortTape(), std::invalid_argument);
+  config_.SetAutoTune(true);
+
+  const auto [statistics, actual_values] = SortTapeOnVirtualClock(value_count);
+
+  VerifyContentEquals(expected_values, actual_values);
+  ASSERT_TRUE(statistics.plan.has_value());
+  EXPECT_LT(statistics.plan->merging_group_size, block_size);
+}
+
+/**
+ * \brief Компаратор, который считает сравнения, чтобы проверять, сливались ли серии.
+ */
+struct CountingComparator {
+  static inline std::atomic_size_t comparison_count = 0;
+
+  bool operator()(const Value f, const Value s) const {
+    ++comparison_count;
+    return f < s;
+  }
+};
+
+TEST_F(TapeSorterTest, SortRunsWithDisjointRanges) {
+  constexpr size_t block_size = 10000;
+  constexpr size_t block_count = 10;
+  config_.SetMaxValueCountPerThread(block_size);
+  config_.SetMaxMergingGroupSize(4);
+  config_.SetRunFormationMode(RunFormationMode::kNaturalRuns);
+  // упорядоченные блоки идут по убыванию, поэтому каждый становится отдельной естественной серией,
+  // а их диапазоны значений частично пересекаются при overlap > 0
+  for (const size_t thread_count : {1, 4}) {
+    for (const int overlap : {0, 5}) {
+      std::vector<Value> values;
+      for (auto block = static_cast<int>(block_count) - 1; block >= 0; --block) {
+        auto block_values = GenerateRandomArray<Value>(block_size);
+        for (auto &value : block_values) {
+          const auto offset = static_cast<unsigned char>(value) % (20 + overlap);
+          value = static_cast<Value>(-100 + block * 20 + static_cast<int>(offset));
+        }
+        std::ranges::sort(block_values);
+        values.insert(values.end(), block_values.begin(), block_values.end());
+      }
+      CreateFileWithBinaryContent(input_file_path_, values);
+      std::ranges::sort(values);
+      config_.SetMaxThreadCount(thread_count);
+      CountingComparator::comparison_count = 0;
+
+      const auto actual_values = SortTape<CountingComparator>();
+
+      VerifyContentEquals(values, actual_values);
+      if (overlap == 0) {
+        // поиск серий сравнивает каждое значение примерно один раз, а непересекающиеся серии
+        // только копируются блоками, без дерева проигравших и параллельного слияния
+        EXPECT_LT(CountingComparator::comparison_count, values.size() + values.size() / 20)
+            << "Thread count " << thread_count;
+      }
+    }
+  }
+}
+
+TEST_F(TapeSorterTest, SortInterleavedClustersWithGalloping) {
+  constexpr size_t block_size = 10000;
+  constexpr int block_count = 10;
+  config_.SetMaxValueCountPerThread(block_size);
+  config_.SetMaxThreadCount(1);
+  config_.SetRunFormationMode(RunFormationMode::kNaturalRuns);
+  // каждый упорядоченный блок состоит из 6 кластеров, которые чередуются с кластерами других
+  // блоков, поэтому при слиянии одна серия выигрывает подряд много раз
+  std::vector<Value> values;
+  for (int block = 0; block < block_count; ++block) {
+    auto block_values = GenerateRandomArray<Value>(block_size);
+    for (auto &value : block_values) {
+      const auto random = static_cast<unsigned char>(value);
+      value = static_cast<Value>(-128 + random % 6 * 40 + block * 4 + random % 4);
+    }
+    std::ranges::sort(block_values);
+    values.insert(values.end(), block_values.begin(), block_values.end());
+  }
+  CreateFileWithBinaryContent(input_file_path_, values);
+  std::ranges::sort(values);
+  CountingComparator::comparison_count = 0;
+
+  const auto actual_values = SortTape<CountingComparator>();
+
+  VerifyContentEquals(values, actual_values);
+  // поиск серий сравнивает каждое значение примерно один раз, а слияние без копирования кластеров
+  // блоками сравнивало бы каждое значение еще несколько раз в дереве проигравших
+  EXPECT_LT(CountingComparator::comparison_count, values.size() + values.size() / 2);
+}
+
+TEST_F(TapeSorterTest, SortWithHugePageBuffers) {
+  constexpr auto value_count = 3000000;
+  const auto expected_values = InitInputDataWithRandomValues(value_count);
+  config_.SetMaxValueCountPerThread(value_count / 3);
+  config_.SetMaxThreadCount(2);
+  config_.SetHugePageBuffers(true);
+
+  const auto actual_values = SortTape();
+
+  VerifyContentEquals(expected_values, actual_values);
+}
+
+TEST_F(TapeSorterTest, SortRespectsMemoryLimitWithSlowTempTapes) {
+  using Value = std::int32_t;
+  constexpr size_t memory_limit = 2_MiB;
+  constexpr size_t value_count = 16 * memory_limit / sizeof(Value);
+  CreateFileWithBinaryContent(input_file_path_, GenerateRandomArray<Value>(value_count));
+  config_.SetMemoryLimit(memory_limit);
+  config_.SetMaxThreadCount(2);
+  config_.SetMaxValueCountPerThread(memory_limit / 2 / sizeof(Value));
+  config_.SetMaxMergingGroupSize(4);
+  const auto tape_provider = std::make_shared<SlowWriteTapeProvider<Value>>(config_, 10ms);
+  FileTape<Value, false> input_tape(config_, input_file_path_);
+  FileTape<Value> output_tape(config_, output_file_path_);
+  const auto peak_reset = ResetPeakResidentMemory();
+  const auto resident_before = GetProcessMemory("VmRSS");
+
+  const auto statistics = TapeSorter<Value>(config_, tape_provider).Sort(input_tape, output_tape);
+  const auto peak_growth = GetProcessMemory("VmHWM") - resident_before;
+
+  // без ограничения в памяти оказался бы почти весь вход, то есть буферы всех его блоков
+  EXPECT_LE(statistics.peak_buffer_memory, memory_limit)
+      << "Sorting mustn't hold more blocks than fit the limit";
+  if (peak_reset) {
+    // сверх лимита память занимают только буферы файловых потоков лент, стеки потоков и кучи
+    // аллокатора
+    EXPECT_LE(peak_growth, memory_limit + 1_MiB);
+  }
+  output_tape.MoveToBegin();
+  EXPECT_TRUE(std::ranges::is_sorted(ReadAllFromTape(output_tape)));
+}
+
+TEST_F(TapeSorterTest, UnknownRunFormationMode) {
+  const auto expected_values = InitInputDataWithRandomValues(10);
+  config_.SetRunFormationMode(static_cast<RunFormationMode>(100));
+
+  ASSERT_THROW(SortTape(), std::invalid_argument);
+}
+
 TEST_F(TapeSorterTest, TooSmallMemoryLimit) {
   const auto expected_values = InitInputDataWithRandomValues(10);
   config_.SetMemoryLimit(sizeof(Value));
@@ -96,4 +833,11 @@ TEST_F(TapeSorterTest, TooSmallMemoryLimit) {
   ASSERT_THROW(SortTape(), std::invalid_argument);
 }
 
+TEST_F(TapeSorterTest, TooSmallMergingGroupSize) {
+  const auto expected_values = InitInputDataWithRandomValues(10);
+  config_.SetMaxMergingGroupSize(1);
+
+  ASSERT_THROW(SortTape(), std::invalid_argument);
+}
+
 }  // namespace sot::test
@@ -22,6 +22,12 @@ using namespace files;
 template <typename Value>
 class TapeSorterTestBase : public TestBase {
  public:
+  /// Отсортированные значения выходной ленты вместе со статистикой сортировки.
+  struct SortResult {
+    SortStatistics statistics;
+    std::vector<Value> values;
+  };
+
   std::shared_ptr<TempTapeProvider<Value>> tape_provider_;
   path input_file_path_;
   path output_file_path_;
@@ -34,6 +40,17 @@ class TapeSorterTestBase : public TestBase {
    */
   template <typename Comparator = std::less<Value>>
   [[nodiscard]] std::vector<Value> SortTape() const;
+  /**
+   * \brief Выполнить сортировку по виртуальным часам лент, на которых чтение и запись каждого
+   * значения занимают по секунде.
+   *
+   * \tparam Comparator компаратор, по умолчанию используется std::less<Value>.
+   * \param value_count количество значений на входной ленте, если оно передается сортировке.
+   */
+  template <typename Comparator = std::less<Value>>
+  [[nodiscard]] SortResult SortTapeOnVirtualClock(
+      std::optional<size_t> value_count = std::nullopt
+  );
   /**
    * \brief Создать файл, заполненный случайными значениями.
    *
@@ -66,6 +83,20 @@ std::vector<Value> TapeSorterTestBase<Value>::SortTape() const {
   return ReadAllFromTape(output_tape);
 }
 
+template <typename Value>
+template <typename Comparator>
+auto TapeSorterTestBase<Value>::SortTapeOnVirtualClock(const std::optional<size_t> value_count)
+    -> SortResult {
+  config_.SetReadDuration(1s);
+  config_.SetWriteDuration(1s);
+  config_.SetLatencyMode(LatencyMode::kVirtualClock);
+  FileTape<Value, false> input_tape(config_, input_file_path_);
+  FileTape<Value> output_tape(config_, output_file_path_);
+  const TapeSorter<Value, Comparator> sorter(config_, tape_provider_);
+  const auto statistics = sorter.Sort(input_tape, output_tape, value_count);
+  return {statistics, ReadAllFromTape(output_tape)};
+}
+
 template <typename Value>
 template <typename Comparator>
 std::vector<Value> TapeSorterTestBase<Value>::InitInputDataWithRandomValues(
@@ -0,0 +1,86 @@
+#include "temp_file_tape_provider.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "fake_configuration.h"
+#include "test_utils.h"
+
+namespace sot::test {
+
+using Value = std::int32_t;
+
+class TempFileTapeProviderTest : public testing::TestWithParam<bool> {
+ public:
+  FakeConfiguration config_;
+
+  TempFileTapeProviderTest();
+};
+
+TempFileTapeProviderTest::TempFileTapeProviderTest() {
+  config_.SetZeroDurations();
+  config_.SetDirectIoChunkSize(4_KiB);
+  config_.SetTempTapeDirectIo(GetParam());
+}
+
+TEST_P(TempFileTapeProviderTest, TapeFileIsRemovedRightAfterOpening) {
+  const auto expected_values = GenerateRandomArray<Value>(10000);
+  const TempFileTapeProvider<Value> under_test(config_);
+
+  const auto tape = under_test.Get();
+  tape->WriteN(expected_values);
+  tape->MoveToBegin();
+
+  EXPECT_TRUE(std::filesystem::is_empty(under_test.GetDirectory()));
+  VerifyContentEquals(expected_values, ReadAllFromTape(*tape));
+}
+
+TEST_P(TempFileTapeProviderTest, ConcurrentlyProvidedTapesAreIndependent) {
+  constexpr size_t thread_count = 8;
+  constexpr size_t value_count = 5000;
+  const TempFileTapeProvider<Value> under_test(config_);
+
+  std::vector<std::unique_ptr<Tape<Value>>> tapes(thread_count);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&under_test, &tape = tapes[i], i]() {
+      tape = under_test.Get();
+      tape->WriteN(std::vector(value_count, static_cast<Value>(i)));
+      tape->MoveToBegin();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < thread_count; ++i) {
+    VerifyContentEquals(
+        std::vector(value_count, static_cast<Value>(i)), ReadAllFromTape(*tapes[i])
+    );
+  }
+}
+
+TEST_P(TempFileTapeProviderTest, ProvidersUseDifferentDirectories) {
+  const TempFileTapeProvider<Value> first(config_);
+  const TempFileTapeProvider<Value> second(config_);
+
+  EXPECT_NE(first.GetDirectory(), second.GetDirectory());
+}
+
+TEST_P(TempFileTapeProviderTest, ReportTapeBufferSize) {
+  config_.SetFileBufferSize(16_KiB);
+  config_.SetDirectIoQueueDepth(3);
+  const TempFileTapeProvider<Value> under_test(config_);
+
+  EXPECT_EQ(GetParam() ? 3 * 4_KiB : 16_KiB, under_test.GetBufferSize());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FileAndDirectIo,
+    TempFileTapeProviderTest,
+    testing::Bool(),
+    [](const testing::TestParamInfo<bool> &info) { return info.param ? "DirectIo" : "File"; }
+);
+
+}  // namespace sot::test
@@ -2,8 +2,29 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+
 namespace sot::test {
 
+bool ResetPeakResidentMemory() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.flush();
+  return clear_refs.good();
+}
+
+size_t GetProcessMemory(const std::string &field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.starts_with(field + ":")) {
+      // значения указаны в килобайтах
+      return std::stoull(line.substr(field.size() + 1)) * 1024;
+    }
+  }
+  return 0;
+}
+
 std::string ReadAllFromTapeAsString(Tape<char> &tape) {
   const auto chars = tape.ReadN(std::string::npos);
   return {chars.begin(), chars.end()};
@@ -57,6 +57,17 @@ std::ostream &operator<<(std::ostream &out, const std::vector<Value> &values) {
   return out;
 }
 
+/**
+ * \brief Сбросить пиковое значение резидентной памяти процесса (VmHWM) до текущего.
+ * \return false - если сбросить не удалось.
+ */
+bool ResetPeakResidentMemory();
+
+/**
+ * \brief Получить значение поля /proc/self/status в байтах, например, VmRSS или VmHWM.
+ */
+size_t GetProcessMemory(const std::string &field);
+
 /**
  * \brief Прочитать все содержимое устройства.
  *